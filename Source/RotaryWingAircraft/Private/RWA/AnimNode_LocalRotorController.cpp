@@ -0,0 +1,89 @@
+﻿#include "RWA/AnimNode_LocalRotorController.h"
+#include "RWA/HeliAnimInstance.h"
+
+
+void FAnimNode_RWA_LocalRotorController::Initialize_AnyThread(FAnimationInitializeContext const& ctx)
+{
+	FAnimNode_Base::Initialize_AnyThread(ctx);
+	Source.Initialize(ctx);
+
+	m_Proxy = static_cast<FRWA_HeliAnimInstanceProxy*>(ctx.AnimInstanceProxy);
+}
+
+void FAnimNode_RWA_LocalRotorController::CacheBones_AnyThread(FAnimationCacheBonesContext const& ctx)
+{
+	Source.CacheBones(ctx);
+
+	CacheRotors(ctx.AnimInstanceProxy->GetRequiredBones());
+}
+
+void FAnimNode_RWA_LocalRotorController::CacheRotors(FBoneContainer const& requiredBones)
+{
+	TArray<FRWA_RotorAnimData> const& data = m_Proxy->GetAnimData();
+	int32 len = data.Num();
+	m_Rotors.Reset(len);
+	m_RotorSetupSerial = m_Proxy->GetRotorSetupSerial();
+
+	for (int32 i = 0; i < len; ++i) {
+		FBoneReference boneRef { data[i].BoneName };
+		if (!boneRef.Initialize(requiredBones))
+			continue;
+
+		FCompactPoseBoneIndex idx = boneRef.GetCompactPoseIndex(requiredBones);
+
+		// Accumulate the reference-pose rotation of the bone's ancestors, so the
+		// component-space torque normal can be expressed in the bone's parent space
+		FQuat parentRotation = FQuat::Identity;
+		for (FCompactPoseBoneIndex parent = requiredBones.GetParentBoneIndex(idx);
+			parent.IsValid();
+			parent = requiredBones.GetParentBoneIndex(parent))
+		{
+			parentRotation = requiredBones.GetRefPoseTransform(parent).GetRotation() * parentRotation;
+		}
+
+		FVector axis = parentRotation.UnrotateVector(data[i].TorqueNormal);
+		m_Rotors.Emplace(i, idx, axis.GetSafeNormal());
+	}
+
+	// Sort by bone index
+	m_Rotors.Sort([](FRWA_LocalRotorLookupData const& a, FRWA_LocalRotorLookupData const& b) -> bool {
+		return a.BoneIndex < b.BoneIndex;
+	});
+}
+
+void FAnimNode_RWA_LocalRotorController::Update_AnyThread(FAnimationUpdateContext const& ctx)
+{
+	GetEvaluateGraphExposedInputs().Execute(ctx);
+	Source.Update(ctx);
+}
+
+void FAnimNode_RWA_LocalRotorController::Evaluate_AnyThread(FPoseContext& output)
+{
+	Source.Evaluate(output);
+
+	// The rotor setup may have changed since our bones were cached, leaving us
+	// with indices into the old one
+	if (m_RotorSetupSerial != m_Proxy->GetRotorSetupSerial())
+		CacheRotors(output.Pose.GetBoneContainer());
+
+	TArray<FRWA_RotorAnimData> const& data = m_Proxy->GetAnimData();
+
+	for (FRWA_LocalRotorLookupData const& rotor : m_Rotors) {
+		if (data[rotor.Index].IsBlurred)
+			continue;
+
+		FQuat q = m_Proxy->GetRotorRotation(rotor.Index, rotor.LocalAxis);
+
+		FTransform& xform = output.Pose[rotor.BoneIndex];
+		xform.SetRotation(q * xform.GetRotation());
+	}
+}
+
+void FAnimNode_RWA_LocalRotorController::GatherDebugData(FNodeDebugData& data)
+{
+	FString debugLine = data.GetNodeName(this);
+	debugLine += FString::Printf(TEXT("(Rotors: %d)"), m_Rotors.Num());
+	data.AddDebugItem(debugLine);
+
+	Source.GatherDebugData(data);
+}
@@ -1,4 +1,4 @@
-#include "RWA/AnimNode_RotorController.h"
+﻿#include "RWA/AnimNode_RotorController.h"
 #include "RWA/HeliAnimInstance.h"
 
 
@@ -18,10 +18,24 @@ void FAnimNode_RWA_RotorController::InitializeBoneReferences(FBoneContainer cons
 	TArray<FRWA_RotorAnimData> const& data = m_Proxy->GetAnimData();
 	int32 len = data.Num();
 	m_Rotors.Empty(len);
+	m_RotorSetupSerial = m_Proxy->GetRotorSetupSerial();
 
-	for (int32 i = 0; i < len; ++i) {
-		auto* rotor = new (m_Rotors) FRWA_RotorLookupData { i, { data[i].BoneName }};
+	auto add = [&](int32 idx, FName boneName, ERWA_RotorBone kind) {
+		if (boneName == EName::None)
+			return;
+
+		auto* rotor = new (m_Rotors) FRWA_RotorLookupData { idx, { boneName }, kind };
 		rotor->BoneRef.Initialize(requiredBones);
+	};
+
+	for (int32 i = 0; i < len; ++i) {
+		FRWA_RotorLinkageSetup const& linkage = data[i].Linkage;
+
+		add(i, data[i].BoneName, ERWA_RotorBone::Rotor);
+		add(i, linkage.SwashplateBoneName, ERWA_RotorBone::Swashplate);
+
+		for (FName blade : linkage.BladeBoneNames)
+			add(i, blade, ERWA_RotorBone::Blade);
 	}
 
 	// Sort by bone index
@@ -34,13 +48,48 @@ bool FAnimNode_RWA_RotorController::IsValidToEvaluate(
 	USkeleton const* skel,
 	FBoneContainer const& requiredBones)
 {
+	// The rotor setup may have changed since our bones were cached, leaving us
+	// with indices into the old one
+	if (m_RotorSetupSerial != m_Proxy->GetRotorSetupSerial())
+		InitializeBoneReferences(requiredBones);
+
+	// Skip the component-space conversion entirely when every rotor is blurred
+	// and there's no swashplate to animate
+	TArray<FRWA_RotorAnimData> const& data = m_Proxy->GetAnimData();
+
 	for (auto const& rotor : m_Rotors)
-		if (rotor.BoneRef.IsValidToEvaluate(requiredBones))
+		if (rotor.BoneRef.IsValidToEvaluate(requiredBones)
+			&& (rotor.Kind == ERWA_RotorBone::Swashplate || !data[rotor.Index].IsBlurred))
+		{
 			return true;
+		}
 
 	return false;
 }
 
+/**
+ * Get a bone's component-space transform, accounting for any of its ancestors
+ * already written to the output. Bone transforms must be sorted by bone index.
+ */
+static FTransform GetUpdatedComponentSpaceTransform(
+	FCSPose<FCompactPose>& pose,
+	FCompactPoseBoneIndex idx,
+	TArray<FBoneTransform> const& written)
+{
+	FCompactPoseBoneIndex parent = pose.GetPose().GetParentBoneIndex(idx);
+	if (written.IsEmpty() || !parent.IsValid() || parent < written[0].BoneIndex)
+		return pose.GetComponentSpaceTransform(idx);
+
+	FTransform const& local = pose.GetPose()[idx];
+	auto const* updated = written.FindByPredicate([parent](FBoneTransform const& bt) -> bool {
+		return bt.BoneIndex == parent;
+	});
+	if (updated)
+		return local * updated->Transform;
+
+	return local * GetUpdatedComponentSpaceTransform(pose, parent, written);
+}
+
 void FAnimNode_RWA_RotorController::EvaluateSkeletalControl_AnyThread(
 	FComponentSpacePoseContext& inout_ctx,
 	TArray<FBoneTransform>& out_boneTransforms)
@@ -51,30 +100,45 @@ void FAnimNode_RWA_RotorController::EvaluateSkeletalControl_AnyThread(
 	FBoneContainer const& container = inout_ctx.Pose.GetPose().GetBoneContainer();
 
 	for (FRWA_RotorLookupData const& rotor : m_Rotors) {
-		if (!rotor.BoneRef.IsValidToEvaluate())
+		FRWA_RotorAnimData const& anim = data[rotor.Index];
+		if (!rotor.BoneRef.IsValidToEvaluate()
+			|| (rotor.Kind != ERWA_RotorBone::Swashplate && anim.IsBlurred))
+		{
 			continue;
+		}
 
+		// Linkage bones are typically children of the rotor, so their transforms
+		// need to follow the rotor's updated transform
 		FCompactPoseBoneIndex idx = rotor.BoneRef.GetCompactPoseIndex(container);
-		FTransform xform = inout_ctx.Pose.GetComponentSpaceTransform(idx);
-
-		FAnimationRuntime::ConvertCSTransformToBoneSpace(
-			inout_ctx.AnimInstanceProxy->GetComponentTransform(),
-			inout_ctx.Pose,
-			xform,
-			idx,
-			BCS_ComponentSpace
-		);
-
-		FQuat q { data[rotor.Index].Rotation };
-		xform.SetRotation(q * xform.GetRotation());
-
-		FAnimationRuntime::ConvertBoneSpaceTransformToCS(
-			inout_ctx.AnimInstanceProxy->GetComponentTransform(),
-			inout_ctx.Pose,
-			xform,
-			idx,
-			BCS_ComponentSpace
-		);
+		FTransform xform = GetUpdatedComponentSpaceTransform(inout_ctx.Pose, idx, out_boneTransforms);
+		FRWA_RotorLinkageState const& linkage = m_Proxy->GetLinkageState(rotor.Index);
+
+		// The torque normal is expressed in component space, so rotations can be
+		// applied to the component-space transform directly
+		switch (rotor.Kind) {
+			case ERWA_RotorBone::Rotor: {
+				FQuat q = m_Proxy->GetRotorRotation(rotor.Index, anim.TorqueNormal);
+				xform.SetRotation(q * xform.GetRotation());
+				break;
+			}
+			case ERWA_RotorBone::Swashplate: {
+				xform.SetRotation(linkage.SwashplateTilt * xform.GetRotation());
+				xform.AddToTranslation(linkage.SwashplateOffset);
+				break;
+			}
+			case ERWA_RotorBone::Blade: {
+				FVector span = xform.TransformVectorNoScale(anim.Linkage.BladeSpanAxis);
+				float pitch = linkage.CollectivePitch + (span | linkage.CyclicPitchAxis);
+				FQuat q = FQuat(span, pitch);
+
+				FVector flapAxis = (anim.TorqueNormal ^ span).GetSafeNormal();
+				if (!flapAxis.IsZero())
+					q = FQuat(flapAxis, -linkage.ConingAngle) * q;
+
+				xform.SetRotation(q * xform.GetRotation());
+				break;
+			}
+		}
 
 		out_boneTransforms.Emplace(idx, xform);
 	}
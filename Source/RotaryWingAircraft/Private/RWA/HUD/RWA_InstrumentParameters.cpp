@@ -0,0 +1,120 @@
+﻿#include "RWA/HUD/RWA_InstrumentParameters.h"
+
+#include "Materials/MaterialParameterCollection.h"
+#include "Materials/MaterialParameterCollectionInstance.h"
+#include "RWA/HeliMovement.h"
+
+
+URWA_InstrumentParameterComponent::URWA_InstrumentParameterComponent()
+	: Super()
+{
+	PrimaryComponentTick.bCanEverTick = true;
+	PrimaryComponentTick.bStartWithTickEnabled = true;
+
+	// Read the instruments after the physics state for this frame is available
+	PrimaryComponentTick.TickGroup = TG_PostPhysics;
+}
+
+void URWA_InstrumentParameterComponent::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (AActor* owner = GetOwner())
+		m_MovementComponent = owner->FindComponentByClass<URWA_HeliMovementComponent>();
+
+	if (ParameterCollection)
+		if (UWorld* world = GetWorld())
+			m_CollectionInstance = world->GetParameterCollectionInstance(ParameterCollection);
+
+	ResetBindingStates();
+
+	if (!m_MovementComponent.IsValid() || !m_CollectionInstance.IsValid())
+		SetComponentTickEnabled(false);
+}
+
+void URWA_InstrumentParameterComponent::ForceUpdate()
+{
+	ResetBindingStates();
+}
+
+void URWA_InstrumentParameterComponent::ResetBindingStates()
+{
+	m_BindingStates.Reset();
+	m_BindingStates.SetNum(Bindings.Num());
+}
+
+void URWA_InstrumentParameterComponent::TickComponent(float deltaTime, ELevelTick type, TickFn* fn)
+{
+	Super::TickComponent(deltaTime, type, fn);
+
+	URWA_HeliMovementComponent const* mc = m_MovementComponent.Get();
+	UMaterialParameterCollectionInstance* collection = m_CollectionInstance.Get();
+	if (!mc || !collection)
+		return;
+
+	if (OnlyWhenLocallyControlled)
+		if (auto const* pawn = Cast<APawn>(GetOwner()); pawn && !pawn->IsLocallyControlled())
+			return;
+
+	// Bindings can be edited at runtime from Blueprint
+	if (m_BindingStates.Num() != Bindings.Num())
+		ResetBindingStates();
+
+	FRWA_FlightInstruments const instruments = mc->GetFlightInstruments();
+	double const now = GetWorld()->GetTimeSeconds();
+
+	// The collection instance defers its render state update to the end of the
+	// frame, so writing everything back-to-back here costs a single uniform
+	// buffer update, and none at all if nothing changed.
+
+	for (int32 i = 0; i < Bindings.Num(); ++i)
+	{
+		FRWA_InstrumentParameterBinding const& binding = Bindings[i];
+		FBindingState& state = m_BindingStates[i];
+
+		if (binding.ParameterName == EName::None)
+			continue;
+
+		if (state.Written && now < state.NextUpdateTime)
+			continue;
+
+		float value = GetInstrumentValue(instruments, binding.Source);
+		if (!FMath::IsFinite(value))
+			value = UE_BIG_NUMBER;
+		else if (binding.Quantization > 0)
+			value = FMath::GridSnap(value, binding.Quantization);
+
+		if (binding.UpdateFrequency > 0)
+			state.NextUpdateTime = now + (1.0 / binding.UpdateFrequency);
+
+		if (state.Written && state.LastValue == value)
+			continue;
+
+		state.LastValue = value;
+		state.Written = true;
+
+		collection->SetScalarParameterValue(binding.ParameterName, value);
+	}
+}
+
+float URWA_InstrumentParameterComponent::GetInstrumentValue(
+	FRWA_FlightInstruments const& instruments,
+	ERWA_FlightInstrument source)
+{
+	switch (source) {
+		case ERWA_FlightInstrument::Airspeed: return instruments.Airspeed;
+		case ERWA_FlightInstrument::AirspeedKnots: return instruments.AirspeedKnots;
+		case ERWA_FlightInstrument::VerticalSpeed: return instruments.VerticalSpeed;
+		case ERWA_FlightInstrument::Heading: return instruments.Heading;
+		case ERWA_FlightInstrument::Pitch: return instruments.Pitch;
+		case ERWA_FlightInstrument::Bank: return instruments.Bank;
+		case ERWA_FlightInstrument::RadarAltitude: return instruments.RadarAltitude;
+		case ERWA_FlightInstrument::RPM: return instruments.RPM;
+		case ERWA_FlightInstrument::GLoad: return instruments.GLoad;
+		case ERWA_FlightInstrument::Collective: return instruments.Collective;
+		case ERWA_FlightInstrument::CyclicRoll: return instruments.Cyclic.X;
+		case ERWA_FlightInstrument::CyclicPitch: return instruments.Cyclic.Y;
+		case ERWA_FlightInstrument::AntiTorque: return instruments.AntiTorque;
+	}
+	return 0;
+}
@@ -0,0 +1,299 @@
+﻿#include "RWA/HUD/RWA_RetainerAtlas.h"
+
+#include "ClearQuad.h"
+#include "Engine/TextureRenderTarget2D.h"
+#include "RHICommandList.h"
+
+
+int32 g_RetainerAtlasPageSize = 1024;
+FAutoConsoleVariableRef RWA_RetainerAtlasPageSize {
+	TEXT("Slate.RWARetainerAtlasPageSize"),
+	g_RetainerAtlasPageSize,
+	TEXT("The width and height of the render targets shared by RWA retainer "
+		"widgets using the atlas pool. Only affects newly allocated pages."),
+};
+
+
+FIntPoint FRWA_RetainerAtlasSlot::GetContentOrigin() const
+{
+	return Rect.Min + FIntPoint(FRWA_RetainerAtlasPool::k_Padding);
+}
+
+
+FRWA_RetainerAtlasPool& FRWA_RetainerAtlasPool::Get()
+{
+	static FRWA_RetainerAtlasPool s_instance;
+	return s_instance;
+}
+
+int32 FRWA_RetainerAtlasPool::GetPageSize()
+{
+	uint32 size = FMath::RoundUpToPowerOfTwo((uint32)FMath::Max(g_RetainerAtlasPageSize, 64));
+	return (int32)FMath::Min(size, GetMax2DTextureDimension());
+}
+
+bool FRWA_RetainerAtlasPool::Allocate(
+	FIntPoint size,
+	EPixelFormat format,
+	FRWA_RetainerAtlasSlot& inout_slot)
+{
+	FIntPoint const padded {
+		Align(size.X + k_Padding * 2, k_Granularity),
+		Align(size.Y + k_Padding * 2, k_Granularity),
+	};
+
+	int32 const pageSize = GetPageSize();
+	if (padded.X > pageSize || padded.Y > pageSize) {
+		Release(inout_slot);
+		return false;
+	}
+
+	// Keep the current slot while the content still fits, unless it has shrunk
+	// enough that most of the slot would be wasted
+	if (inout_slot.IsValid()) {
+		FIntPoint const current = inout_slot.Rect.Size();
+		if (m_Pages[inout_slot.Page].Format == format
+			&& padded.X <= current.X
+			&& padded.Y <= current.Y
+			&& current.X * current.Y <= padded.X * padded.Y * 2)
+		{
+			return true;
+		}
+
+		Release(inout_slot);
+	}
+
+	for (int32 i = 0; i < m_Pages.Num(); ++i) {
+		if (m_Pages[i].Format == format
+			&& m_Pages[i].Size >= padded.X
+			&& m_Pages[i].Size >= padded.Y
+			&& TryAllocate(m_Pages[i], padded, inout_slot.Rect))
+		{
+			inout_slot.Page = i;
+			return true;
+		}
+	}
+
+	// Every page is full, so this is the only place pages are added
+	int32 const page = AddPage(pageSize, format);
+	verify(TryAllocate(m_Pages[page], padded, inout_slot.Rect));
+	inout_slot.Page = page;
+
+	return true;
+}
+
+bool FRWA_RetainerAtlasPool::TryAllocate(FPage& page, FIntPoint size, FIntRect& out_rect)
+{
+	// Reuse the tightest released slot that fits
+	int32 bestFree = INDEX_NONE;
+	int32 bestFreeArea = MAX_int32;
+	for (int32 i = 0; i < page.FreeRects.Num(); ++i) {
+		FIntPoint const freeSize = page.FreeRects[i].Size();
+		int32 const area = freeSize.X * freeSize.Y;
+
+		if (freeSize.X >= size.X
+			&& freeSize.Y >= size.Y
+			&& area <= size.X * size.Y * 2
+			&& area < bestFreeArea)
+		{
+			bestFree = i;
+			bestFreeArea = area;
+		}
+	}
+
+	if (bestFree != INDEX_NONE) {
+		out_rect = page.FreeRects[bestFree];
+		page.FreeRects.RemoveAtSwap(bestFree);
+		++page.NumSlots;
+
+		return true;
+	}
+
+	// Otherwise, the shortest shelf with enough room that isn't much too tall
+	FShelf* bestShelf = nullptr;
+	for (FShelf& shelf : page.Shelves) {
+		if (shelf.Height >= size.Y
+			&& shelf.Height <= size.Y * 3 / 2
+			&& shelf.X + size.X <= page.Size
+			&& (!bestShelf || shelf.Height < bestShelf->Height))
+		{
+			bestShelf = &shelf;
+		}
+	}
+
+	// Otherwise, open a new shelf below the last one
+	if (!bestShelf) {
+		if (page.NextShelfY + size.Y > page.Size)
+			return false;
+
+		bestShelf = &page.Shelves.Emplace_GetRef(FShelf{ page.NextShelfY, size.Y, 0 });
+		page.NextShelfY += size.Y;
+	}
+
+	out_rect = FIntRect(
+		FIntPoint(bestShelf->X, bestShelf->Y),
+		FIntPoint(bestShelf->X + size.X, bestShelf->Y + size.Y));
+
+	bestShelf->X += size.X;
+	++page.NumSlots;
+
+	return true;
+}
+
+void FRWA_RetainerAtlasPool::Release(FRWA_RetainerAtlasSlot& inout_slot)
+{
+	if (!inout_slot.IsValid())
+		return;
+
+	if (m_Pages.IsValidIndex(inout_slot.Page)) {
+		FPage& page = m_Pages[inout_slot.Page];
+		FIntRect const& rect = inout_slot.Rect;
+
+		if (--page.NumSlots <= 0) {
+			// The page is empty -- start packing it from scratch. It's freed at
+			// the end of the frame unless another slot is allocated in it first.
+			page.NumSlots = 0;
+			page.NextShelfY = 0;
+			page.Shelves.Reset();
+			page.FreeRects.Reset();
+		}
+		else {
+			FShelf* shelf = page.Shelves.FindByPredicate([&rect](FShelf const& s) -> bool {
+				return s.Y == rect.Min.Y;
+			});
+
+			// Give the space back to the shelf if this was its last slot
+			if (shelf && shelf->X == rect.Max.X)
+				shelf->X = rect.Min.X;
+			else
+				page.FreeRects.Add(rect);
+		}
+	}
+
+	inout_slot = {};
+}
+
+int32 FRWA_RetainerAtlasPool::AddPage(int32 size, EPixelFormat format)
+{
+	// Slots refer to pages by index, so freed pages leave a gap to fill
+	int32 idx = m_Pages.IndexOfByPredicate([](FPage const& page) -> bool {
+		return page.Size == 0;
+	});
+
+	if (idx == INDEX_NONE)
+		idx = m_Pages.AddDefaulted();
+
+	// The render target is created by ApplyPendingPages
+	FPage& page = m_Pages[idx];
+	page = {};
+	page.Size = size;
+	page.Format = format;
+
+	return idx;
+}
+
+void FRWA_RetainerAtlasPool::ApplyPendingPages()
+{
+	for (FPage& page : m_Pages) {
+		if (page.Size == 0)
+			continue;
+
+		if (page.NumSlots == 0) {
+			// Let the render target be collected, and the index be reused
+			page = {};
+			continue;
+		}
+
+		if (page.RenderTarget)
+			continue;
+
+		// Matches the format of the retainers' own render targets. See
+		// SRWA_RetainerWidget::UpdateWidgetRenderer for why these aren't sRGB.
+		auto* rt = NewObject<UTextureRenderTarget2D>();
+		rt->ClearColor = FLinearColor::Transparent;
+		rt->RenderTargetFormat = RTF_RGBA8_SRGB;
+		rt->TargetGamma = 1;
+		rt->SRGB = false;
+
+		bool forceLinearGamma = false;
+		rt->InitCustomFormat(page.Size, page.Size, page.Format, forceLinearGamma);
+		rt->UpdateResourceImmediate(true);
+
+		page.RenderTarget = rt;
+	}
+}
+
+UTextureRenderTarget2D* FRWA_RetainerAtlasPool::GetRenderTarget(int32 page) const
+{
+	return m_Pages.IsValidIndex(page)
+		? m_Pages[page].RenderTarget.Get()
+		: nullptr;
+}
+
+void FRWA_RetainerAtlasPool::ReturnRenderTarget(UTextureRenderTarget2D* rt)
+{
+	if (!rt)
+		return;
+
+	if (m_SpareTargets.Num() >= k_MaxSpareTargets)
+		m_SpareTargets.RemoveAt(0);
+
+	m_SpareTargets.Add(rt);
+}
+
+UTextureRenderTarget2D* FRWA_RetainerAtlasPool::TakeRenderTarget(EPixelFormat format)
+{
+	if (m_SpareTargets.IsEmpty())
+		return nullptr;
+
+	// Any spare will do, but one with the right format can just be resized
+	int32 idx = m_SpareTargets.IndexOfByPredicate([format](UTextureRenderTarget2D const* rt) -> bool {
+		return rt->OverrideFormat == format;
+	});
+
+	if (idx == INDEX_NONE)
+		idx = m_SpareTargets.Num() - 1;
+
+	UTextureRenderTarget2D* result = m_SpareTargets[idx];
+	m_SpareTargets.RemoveAt(idx);
+
+	return result;
+}
+
+void FRWA_RetainerAtlasPool::ClearRegion(UTextureRenderTarget2D* rt, FIntRect const& rect)
+{
+	FTextureRenderTargetResource* resource = rt ? rt->GameThread_GetRenderTargetResource() : nullptr;
+	if (!resource || rect.Area() <= 0)
+		return;
+
+	ENQUEUE_RENDER_COMMAND(RWA_ClearRetainerRegion)(
+		[resource, rect](FRHICommandListImmediate& cmdList)
+		{
+			FRHITexture* texture = resource->GetRenderTargetTexture();
+			if (!texture)
+				return;
+
+			cmdList.Transition(FRHITransitionInfo(texture, ERHIAccess::Unknown, ERHIAccess::RTV));
+
+			FRHIRenderPassInfo passInfo (texture, ERenderTargetActions::Load_Store);
+			cmdList.BeginRenderPass(passInfo, TEXT("RWA_ClearRetainerRegion"));
+			cmdList.SetViewport(rect.Min.X, rect.Min.Y, 0, rect.Max.X, rect.Max.Y, 1);
+			DrawClearQuad(cmdList, FLinearColor::Transparent);
+			cmdList.EndRenderPass();
+
+			cmdList.Transition(FRHITransitionInfo(texture, ERHIAccess::RTV, ERHIAccess::SRVMask));
+		});
+}
+
+void FRWA_RetainerAtlasPool::AddReferencedObjects(FReferenceCollector& collector)
+{
+	for (FPage& page : m_Pages)
+		collector.AddReferencedObject(page.RenderTarget);
+
+	collector.AddReferencedObjects(m_SpareTargets);
+}
+
+FString FRWA_RetainerAtlasPool::GetReferencerName() const
+{
+	return TEXT("FRWA_RetainerAtlasPool");
+}
@@ -33,12 +33,61 @@ void URWA_RetainerBox::SetRenderingPhase(int32 phase, int32 phaseCount)
 		m_Widget->SetRenderingPhase(Phase, PhaseCount);
 }
 
+void URWA_RetainerBox::SetAdaptivePhase(bool enabled, int32 minPhaseCount, int32 maxPhaseCount)
+{
+	AdaptivePhase = enabled;
+	MinPhaseCount = FMath::Max(minPhaseCount, 1);
+	MaxPhaseCount = FMath::Max(maxPhaseCount, MinPhaseCount);
+
+	if (m_Widget.IsValid())
+		m_Widget->SetAdaptivePhase(AdaptivePhase, MinPhaseCount, MaxPhaseCount);
+}
+
+void URWA_RetainerBox::SetPriority(float value)
+{
+	Priority = FMath::Max(value, 0.f);
+
+	if (m_Widget.IsValid())
+		m_Widget->SetPriority(Priority);
+}
+
+void URWA_RetainerBox::SetRenderScale(float value)
+{
+	RenderScale = FMath::Clamp(value, 0.1f, 1.f);
+
+	if (m_Widget.IsValid())
+		m_Widget->SetRenderScale(RenderScale);
+}
+
+void URWA_RetainerBox::SetFormat(ERWA_RetainerFormat value)
+{
+	Format = value;
+
+	if (m_Widget.IsValid())
+		m_Widget->SetFormat(value);
+}
+
 void URWA_RetainerBox::RequestRender()
 {
 	if (m_Widget.IsValid())
 		m_Widget->RequestRender();
 }
 
+void URWA_RetainerBox::InvalidateWidgetRegion(UWidget* widget)
+{
+	if (!m_Widget.IsValid() || !widget)
+		return;
+
+	if (TSharedPtr<SWidget> slateWidget = widget->GetCachedWidget())
+		m_Widget->InvalidateWidgetRegion(*slateWidget);
+}
+
+void URWA_RetainerBox::InvalidateRegion(FVector2D position, FVector2D size)
+{
+	if (m_Widget.IsValid())
+		m_Widget->InvalidateRegion(FSlateRect(position, position + size));
+}
+
 UMaterialInstanceDynamic* URWA_RetainerBox::GetEffectMaterial() const
 {
 	if (m_Widget.IsValid())
@@ -77,11 +126,17 @@ TSharedRef<SWidget> URWA_RetainerBox::RebuildWidget()
 		.RenderOnPhase(RenderOnPhase)
 		.Phase(Phase)
 		.PhaseCount(PhaseCount)
-#if STATS
+		.UseSharedAtlas(UseSharedAtlas)
+		.Priority(Priority)
+		.AdaptivePhase(AdaptivePhase)
+		.MinPhaseCount(MinPhaseCount)
+		.MaxPhaseCount(MaxPhaseCount)
+		.RenderScale(RenderScale)
+		.Format(Format)
+		.HitTestable(HitTestable)
 		.StatId(*FString::Printf(TEXT("%s [%s]"),
 			*GetFName().ToString(),
 			*GetClass()->GetName()))
-#endif
 		;
 
 	if (GetChildrenCount() > 0)
@@ -101,6 +156,12 @@ void URWA_RetainerBox::SynchronizeProperties()
 	Super::SynchronizeProperties();
 
 	m_Widget->SetRetainedRendering(IsDesignTime() ? false : RetainedRendering);
+	m_Widget->SetUseSharedAtlas(UseSharedAtlas);
+	m_Widget->SetPriority(Priority);
+	m_Widget->SetAdaptivePhase(AdaptivePhase, MinPhaseCount, MaxPhaseCount);
+	m_Widget->SetRenderScale(RenderScale);
+	m_Widget->SetFormat(Format);
+	m_Widget->SetHitTestable(HitTestable);
 	m_Widget->SetEffectMaterial(EffectMaterial);
 	m_Widget->SetTextureParameter(TextureParameter);
 	m_Widget->SetWorld(GetWorld());
@@ -150,7 +211,7 @@ bool URWA_RetainerBox::CanEditChange(FProperty const* property) const
 	if (propName == GET_MEMBER_NAME_CHECKED(URWA_RetainerBox, Phase)
 		|| propName == GET_MEMBER_NAME_CHECKED(URWA_RetainerBox, PhaseCount))
 	{
-		return RenderOnPhase && RetainedRendering;
+		return RenderOnPhase && RetainedRendering && !AdaptivePhase;
 	}
 
 	return true;
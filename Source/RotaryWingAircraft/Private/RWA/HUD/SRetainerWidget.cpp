@@ -1,7 +1,12 @@
 ﻿#include "RWA/HUD/SRetainerWidget.h"
 
+#include "Containers/Ticker.h"
 #include "Engine/TextureRenderTarget2D.h"
 #include "Input/HittestGrid.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/ScopeExit.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+#include "RWA/HUD/RWA_RetainerAtlas.h"
 #include "Slate/WidgetRenderer.h"
 
 
@@ -13,6 +18,32 @@ DECLARE_CYCLE_STAT(
 	TEXT("RWA Retainer Widget Paint"),
 	STAT_RWA_RetainerWidgetPaint,
 	STATGROUP_Slate);
+DECLARE_CYCLE_STAT(
+	TEXT("RWA Retainer Widget Draw"),
+	STAT_RWA_RetainerWidgetDraw,
+	STATGROUP_Slate);
+DECLARE_DWORD_COUNTER_STAT(
+	TEXT("RWA Retainer Redraws"),
+	STAT_RWA_RetainerRedraws,
+	STATGROUP_Slate);
+DECLARE_DWORD_COUNTER_STAT(
+	TEXT("RWA Retainer Skipped Draws"),
+	STAT_RWA_RetainerSkipped,
+	STATGROUP_Slate);
+DECLARE_DWORD_COUNTER_STAT(
+	TEXT("RWA Retainer Queued Draws"),
+	STAT_RWA_RetainerQueued,
+	STATGROUP_Slate);
+DECLARE_DWORD_COUNTER_STAT(
+	TEXT("RWA Retainer Resizes"),
+	STAT_RWA_RetainerResizes,
+	STATGROUP_Slate);
+DECLARE_MEMORY_STAT(
+	TEXT("RWA Retainer Render Targets"),
+	STAT_RWA_RetainerTargetMemory,
+	STATGROUP_Slate);
+
+CSV_DEFINE_CATEGORY(RWARetainers, true);
 
 #if !UE_BUILD_SHIPPING
 FRWA_OnRetainedModeChanged SRWA_RetainerWidget::s_OnRetainedModeChangedDelegate {};
@@ -37,6 +68,77 @@ FAutoConsoleVariableRef CVarGlateRWA_EnableRenderWithLocalTransform {
 		"from the parent widget."),
 };
 
+float g_RetainerFrameBudget = 0;
+FAutoConsoleVariableRef RWA_RetainerFrameBudget {
+	TEXT("Slate.RWARetainerFrameBudget"),
+	g_RetainerFrameBudget,
+	TEXT("The time, in microseconds, that RWA retainer widgets may spend drawing "
+		"their content each frame. Retainers over budget are queued for a later "
+		"frame, ordered by priority and how long they've been waiting. 0 means "
+		"unlimited."),
+};
+
+float g_RetainerMaxStaleness = 0.25f;
+FAutoConsoleVariableRef RWA_RetainerMaxStaleness {
+	TEXT("Slate.RWARetainerMaxStaleness"),
+	g_RetainerMaxStaleness,
+	TEXT("The longest time, in seconds, that an RWA retainer widget can be kept "
+		"waiting by the frame budget. Retainers this stale draw regardless of the "
+		"budget. 0 disables the guarantee."),
+};
+
+float g_RetainerRenderScale = 1.f;
+FAutoConsoleVariableRef RWA_RetainerRenderScale {
+	TEXT("Slate.RWARetainerRenderScale"),
+	g_RetainerRenderScale,
+	TEXT("Scales the resolution of every RWA retainer widget's render target, "
+		"on top of the widget's own Render Scale. Intended for scalability "
+		"settings on high-resolution displays. Hit-testable retainers always "
+		"render at full scale."),
+};
+
+int32 g_RetainerTargetBucketSize = 64;
+FAutoConsoleVariableRef RWA_RetainerTargetBucketSize {
+	TEXT("Slate.RWARetainerTargetBucketSize"),
+	g_RetainerTargetBucketSize,
+	TEXT("RWA retainer widgets' render targets are allocated in multiples of "
+		"this many pixels, so small size changes don't reallocate them. 0 rounds "
+		"up to powers of two instead."),
+};
+
+float g_RetainerReleaseIdleTime = 30.f;
+FAutoConsoleVariableRef RWA_RetainerReleaseIdleTime {
+	TEXT("Slate.RWARetainerReleaseIdleTime"),
+	g_RetainerReleaseIdleTime,
+	TEXT("RWA retainer widgets that haven't been painted (because they, or the "
+		"HUD they're in, are hidden or collapsed) for this many seconds release "
+		"their render targets until they're visible again. 0 keeps them forever."),
+};
+
+bool g_RetainerPoolReleasedTargets = false;
+FAutoConsoleVariableRef RWA_RetainerPoolReleasedTargets {
+	TEXT("Slate.RWARetainerPoolReleasedTargets"),
+	g_RetainerPoolReleasedTargets,
+	TEXT("Whether render targets released by idle RWA retainer widgets are kept "
+		"in a small shared pool for reuse, instead of being freed."),
+};
+
+float g_RetainerDirtyRegionThreshold = 0.5f;
+FAutoConsoleVariableRef RWA_RetainerDirtyRegionThreshold {
+	TEXT("Slate.RWARetainerDirtyRegionThreshold"),
+	g_RetainerDirtyRegionThreshold,
+	TEXT("When the regions invalidated in an RWA retainer widget cover more than "
+		"this fraction of its content, the whole content is redrawn instead. 0 "
+		"disables partial redraws."),
+};
+
+FAutoConsoleCommand RWA_DumpRetainers {
+	TEXT("Slate.RWADumpRetainers"),
+	TEXT("Prints the render target size, draw times and redraw counts of every "
+		"live RWA retainer widget, most expensive first."),
+	FConsoleCommandWithOutputDeviceDelegate::CreateStatic(&SRWA_RetainerWidget::DumpLiveRetainers),
+};
+
 static bool IsRetainedRenderingEnabled()
 {
 	return g_EnableRetainedRendering != 0;
@@ -53,6 +155,7 @@ public:
 	FWidgetRenderer* WidgetRenderer = nullptr;
 	TObjectPtr<UTextureRenderTarget2D> RenderTarget = nullptr;
 	TObjectPtr<UMaterialInstanceDynamic> DynamicEffect = nullptr;
+	FRWA_RetainerAtlasSlot AtlasSlot = {};
 
 public:
 	FRWA_RenderResources() = default;
@@ -72,6 +175,15 @@ public:
 	{
 		return TEXT("FRWA_RenderResources");
 	}
+
+	/** The render target the content is currently drawn into */
+	UTextureRenderTarget2D* GetTarget() const
+	{
+		if (AtlasSlot.IsValid())
+			return FRWA_RetainerAtlasPool::Get().GetRenderTarget(AtlasSlot.Page);
+
+		return RenderTarget;
+	}
 };
 
 
@@ -79,9 +191,13 @@ public:
 
 TArray<SRWA_RetainerWidget*,TInlineAllocator<3>> SRWA_RetainerWidget::s_WaitingToRender {};
 
-int32 SRWA_RetainerWidget::s_MaxRetainerWorkPerFrame = 0;
+TFrameValue<double> SRWA_RetainerWidget::s_RetainerTimeThisFrame {};
+
+TArray<SRWA_RetainerWidget*> SRWA_RetainerWidget::s_PendingResizes {};
+
+TArray<SRWA_RetainerWidget*> SRWA_RetainerWidget::s_LiveRetainers {};
 
-TFrameValue<int32> SRWA_RetainerWidget::s_RetainerWorkThisFrame = 3;
+int32 SRWA_RetainerWidget::s_NextStaggerIndex = 0;
 
 SRWA_RetainerWidget::SRWA_RetainerWidget()
 	: m_PrevRenderSize(FIntPoint::NoneValue)
@@ -109,6 +225,8 @@ SRWA_RetainerWidget::SRWA_RetainerWidget()
 	SetInvalidationRootWidget(*this);
 	SetInvalidationRootHittestGrid(m_HitTestGrid.Get());
 	SetCanTick(false);
+
+	s_LiveRetainers.Add(this);
 }
 
 SRWA_RetainerWidget::~SRWA_RetainerWidget()
@@ -123,11 +241,15 @@ SRWA_RetainerWidget::~SRWA_RetainerWidget()
 	#endif
 	}
 
+	FRWA_RetainerAtlasPool::Get().Release(m_RenderResources->AtlasSlot);
+
 	// Begin deferred cleanup of rendering resources.
 	// DO NOT delete here. Will be deleted when safe.
 	BeginCleanup(m_RenderResources);
 
 	s_WaitingToRender.Remove(this);
+	s_PendingResizes.Remove(this);
+	s_LiveRetainers.RemoveSwap(this);
 }
 
 // ReSharper disable once CppMemberFunctionMayBeConst
@@ -167,20 +289,18 @@ void SRWA_RetainerWidget::UpdateWidgetRenderer()
 void SRWA_RetainerWidget::Construct(FArguments const& args)
 {
 	STAT(m_StatId = FDynamicStats::CreateStatId<FStatGroup_STATGROUP_Slate>(args._StatId));
-
-	auto* rt = NewObject<UTextureRenderTarget2D>();
-	rt->ClearColor = FLinearColor::Transparent;
-	rt->RenderTargetFormat = RTF_RGBA8_SRGB;
-
-	m_RenderResources->RenderTarget = rt;
-	m_SurfaceBrush.SetResourceObject(rt);
+	m_StatName = args._StatId;
+#if STATS
+	if (!m_StatName.IsNone()) {
+		m_DrawStatId = FDynamicStats::CreateStatId<FStatGroup_STATGROUP_Slate>(
+			FString::Printf(TEXT("%s Draw"), *m_StatName.ToString()));
+	}
+#endif
 
 	// deubanks: We don't want Retainer Widgets blocking hit testing for tooltips
 	m_VirtualWindow->SetVisibility(EVisibility::SelfHitTestInvisible);
 	m_VirtualWindow->SetShouldResolveDeferred(false);
 
-	UpdateWidgetRenderer();
-
 	m_Widget = args._Content.Widget;
 
 	m_RenderOnPhase = args._RenderOnPhase;
@@ -189,18 +309,40 @@ void SRWA_RetainerWidget::Construct(FArguments const& args)
 	m_Phase = args._Phase;
 	m_PhaseCount = args._PhaseCount;
 
+	m_AdaptivePhase = false;
+	m_StaggerIndex = s_NextStaggerIndex++;
+	SetAdaptivePhase(args._AdaptivePhase, args._MinPhaseCount, args._MaxPhaseCount);
+
 	m_LastDrawTime = FApp::GetCurrentTime();
+	m_LastPaintTime = m_LastDrawTime;
 	m_LastTickedFrame = 0;
+	m_LastQueuedFrame = INDEX_NONE;
+	m_WaitStartTime = -1;
+
+	m_Priority = FMath::Max(args._Priority, 0.f);
+	m_DrawCost = 0;
 
 	m_EnableRetainedRenderingDesire = true;
 	m_EnableRetainedRendering = false;
 	m_EnableRenderWithLocalTransform = args._RenderWithLocalTransform;
+	m_UseSharedAtlas = args._UseSharedAtlas;
+	m_HitTestable = args._HitTestable;
+	m_RenderScale = args._RenderScale;
+	m_Format = args._Format;
+	m_AppliedRenderScale = 1.f;
+	m_PendingTargetSize = FIntPoint::NoneValue;
 	SetVolatilePrepass(m_EnableRetainedRendering);
 
 	RefreshRenderingMode();
 	m_RenderRequested = true;
+	m_FullRedrawRequested = true;
+	m_ContentCacheClipped = false;
+	m_ContentInvalidated = false;
 	m_InvalidSizeLogged = false;
 
+	m_ContentOrigin = FVector2f::ZeroVector;
+	m_ContentScale = FVector2f::UnitVector;
+
 	ChildSlot[ m_Widget.ToSharedRef() ];
 
 	if (FSlateApplication::IsInitialized()) {
@@ -215,6 +357,17 @@ void SRWA_RetainerWidget::Construct(FArguments const& args)
 				FConsoleVariableDelegate::CreateStatic(&Self::OnRetainerModeCVarChanged));
 		}
 	#endif
+
+		static bool s_registeredCallbacks = false;
+		if (!s_registeredCallbacks) {
+			s_registeredCallbacks = true;
+
+			FCoreDelegates::OnEndFrame.AddStatic(&Self::ApplyPendingResizes);
+			FCoreDelegates::OnEndFrame.AddStatic(&Self::PublishFrameStats);
+			FTSTicker::GetCoreTicker().AddTicker(
+				FTickerDelegate::CreateStatic(&Self::ReleaseIdleRenderResources),
+				1.f);
+		}
 	}
 }
 
@@ -248,6 +401,7 @@ void SRWA_RetainerWidget::OnRetainerModeChanged()
 	RefreshRenderingMode();
 
 	m_RenderRequested = true;
+	m_FullRedrawRequested = true;
 }
 
 void SRWA_RetainerWidget::OnRootInvalidated()
@@ -270,6 +424,71 @@ void SRWA_RetainerWidget::SetRetainedRendering(bool value)
 	}
 }
 
+void SRWA_RetainerWidget::SetUseSharedAtlas(bool value)
+{
+	if (m_UseSharedAtlas != value) {
+		m_UseSharedAtlas = value;
+		RequestRender();
+	}
+}
+
+void SRWA_RetainerWidget::SetHitTestable(bool value)
+{
+	if (m_HitTestable != value) {
+		m_HitTestable = value;
+
+		// Drop whatever the content registered while it was hit-testable
+		if (!m_HitTestable)
+			m_HitTestGrid->Clear();
+
+		RequestRender();
+	}
+}
+
+void SRWA_RetainerWidget::SetFormat(ERWA_RetainerFormat value)
+{
+	if (m_Format != value) {
+		m_Format = value;
+		RequestRender();
+	}
+}
+
+EPixelFormat SRWA_RetainerWidget::GetPixelFormat() const
+{
+	// Coverage would just show up as shades of red without a material to tint it
+	if (RWA::HUD::IsCoverageFormat(m_Format) && !m_RenderResources->DynamicEffect)
+		return PF_B8G8R8A8;
+
+	return RWA::HUD::GetPixelFormat(m_Format);
+}
+
+void SRWA_RetainerWidget::SetRenderScale(float value)
+{
+	if (m_RenderScale != value) {
+		m_RenderScale = value;
+		RequestRender();
+	}
+}
+
+float SRWA_RetainerWidget::GetEffectiveRenderScale() const
+{
+	// The content can only be scaled down when we're in control of its transform
+	if (!m_EnableRenderWithLocalTransform || !g_SlateEnableRenderWithLocalTransform)
+		return 1.f;
+
+	// Scaled-down content would register itself in the hit-test grid at the
+	// scaled-down positions, which the root grid can't map back to the screen
+	if (m_HitTestable)
+		return 1.f;
+
+	return FMath::Clamp(m_RenderScale * g_RetainerRenderScale, 0.1f, 1.f);
+}
+
+void SRWA_RetainerWidget::SetPriority(float value)
+{
+	m_Priority = FMath::Max(value, 0.f);
+}
+
 void SRWA_RetainerWidget::RefreshRenderingMode()
 {
 	bool const renderOffscreen = ShouldBeRenderingOffscreen();
@@ -306,10 +525,12 @@ void SRWA_RetainerWidget::SetEffectMaterial(UMaterialInterface* value)
 	else
 	{
 		m_RenderResources->DynamicEffect = nullptr;
-		m_SurfaceBrush.SetResourceObject(m_RenderResources->RenderTarget);
+		m_SurfaceBrush.SetResourceObject(m_RenderResources->GetTarget());
 	}
 
-	UpdateWidgetRenderer();
+	// The renderer is created on the first draw, so there may not be one yet
+	if (m_RenderResources->WidgetRenderer)
+		UpdateWidgetRenderer();
 }
 
 void SRWA_RetainerWidget::SetTextureParameter(FName value)
@@ -343,12 +564,148 @@ void SRWA_RetainerWidget::SetRenderingPhase(int32 phase, int32 phaseCount)
 	m_PhaseCount = phaseCount;
 }
 
+void SRWA_RetainerWidget::SetAdaptivePhase(bool enabled, int32 minPhaseCount, int32 maxPhaseCount)
+{
+	m_MinPhaseCount = FMath::Max(minPhaseCount, 1);
+	m_MaxPhaseCount = FMath::Max(maxPhaseCount, m_MinPhaseCount);
+
+	if (enabled && !m_AdaptivePhase) {
+		// Start at the full rate, and back off as we learn how often the content changes
+		m_PhaseCount = m_MinPhaseCount;
+		m_Phase = m_StaggerIndex % m_PhaseCount;
+
+		m_AdaptiveWindowStart = GFrameCounter;
+		m_AdaptiveDraws = 0;
+		m_AdaptiveChanges = 0;
+	}
+	else if (enabled) {
+		m_PhaseCount = FMath::Clamp(m_PhaseCount, m_MinPhaseCount, m_MaxPhaseCount);
+		m_Phase = m_StaggerIndex % m_PhaseCount;
+	}
+
+	m_AdaptivePhase = enabled;
+}
+
+void SRWA_RetainerWidget::UpdateAdaptivePhase(bool repainted)
+{
+	++m_AdaptiveDraws;
+	if (repainted)
+		++m_AdaptiveChanges;
+
+	int64 const frames = GFrameCounter - m_AdaptiveWindowStart;
+	if (frames < k_AdaptiveWindowFrames)
+		return;
+
+	int32 phaseCount;
+	if (m_AdaptiveChanges >= m_AdaptiveDraws) {
+		// Every draw had something new, so the content may be changing faster
+		// than we're drawing it -- close in on the full rate quickly
+		phaseCount = m_PhaseCount / 2;
+	}
+	else {
+		double framesPerChange = (double)frames / FMath::Max(m_AdaptiveChanges, 1);
+
+		// Cheap panels can afford to draw twice per change, halving the latency
+		if (m_DrawCost < k_AdaptiveCheapDrawCost)
+			framesPerChange *= 0.5;
+
+		phaseCount = FMath::FloorToInt32(framesPerChange);
+	}
+
+	phaseCount = FMath::Clamp(phaseCount, m_MinPhaseCount, m_MaxPhaseCount);
+	if (phaseCount != m_PhaseCount) {
+		m_PhaseCount = phaseCount;
+		m_Phase = m_StaggerIndex % phaseCount;
+	}
+
+	m_AdaptiveWindowStart = GFrameCounter;
+	m_AdaptiveDraws = 0;
+	m_AdaptiveChanges = 0;
+}
+
 void SRWA_RetainerWidget::RequestRender()
 {
 	m_RenderRequested = true;
+	m_FullRedrawRequested = true;
 	InvalidateRootChildOrder();
 }
 
+void SRWA_RetainerWidget::RequestFullRedraw()
+{
+	m_RenderRequested = true;
+	m_FullRedrawRequested = true;
+	InvalidateRootLayout();
+}
+
+void SRWA_RetainerWidget::InvalidateRegion(FSlateRect const& localRect)
+{
+	FSlateRect const rect {
+		FVector2f(localRect.GetTopLeft2f()) * m_ContentScale,
+		FVector2f(localRect.GetBottomRight2f()) * m_ContentScale,
+	};
+
+	m_DirtyRegion = m_DirtyRegion.IsSet()
+		? m_DirtyRegion->Expand(rect)
+		: rect;
+
+	m_RenderRequested = true;
+}
+
+void SRWA_RetainerWidget::InvalidateWidgetRegion(SWidget const& widget)
+{
+	// Its new desired size isn't known until the next prepass, so cover where
+	// it was painted now, and its new size just before drawing
+	AddWidgetDirtyRegion(widget, FVector2f(widget.GetPaintSpaceGeometry().GetLocalSize()));
+	m_DirtyWidgets.Add(widget.AsShared());
+
+	m_RenderRequested = true;
+}
+
+void SRWA_RetainerWidget::AddWidgetDirtyRegion(SWidget const& widget, FVector2f localSize)
+{
+	// The widget's paint geometry is where it was painted into the render
+	// target last time, in the same space as our content origin
+	FSlateRect const bounds = widget.GetPaintSpaceGeometry()
+		.GetRenderBoundingRect(FSlateRect(FVector2f::ZeroVector, localSize));
+	FSlateRect const rect {
+		FVector2f(bounds.GetTopLeft2f()) - m_ContentOrigin,
+		FVector2f(bounds.GetBottomRight2f()) - m_ContentOrigin,
+	};
+
+	m_DirtyRegion = m_DirtyRegion.IsSet()
+		? m_DirtyRegion->Expand(rect)
+		: rect;
+}
+
+TOptional<FIntRect> SRWA_RetainerWidget::GetDirtyRect(FIntPoint size) const
+{
+	if (m_FullRedrawRequested
+		|| !m_DirtyRegion.IsSet()
+		|| g_RetainerDirtyRegionThreshold <= 0)
+	{
+		return {};
+	}
+
+	FSlateRect const& region = m_DirtyRegion.GetValue();
+
+	// Pad by a pixel to catch anti-aliased edges
+	FIntRect rect {
+		FMath::FloorToInt32(region.Left) - 1,
+		FMath::FloorToInt32(region.Top) - 1,
+		FMath::CeilToInt32(region.Right) + 1,
+		FMath::CeilToInt32(region.Bottom) + 1,
+	};
+	rect.Clip(FIntRect(FIntPoint::ZeroValue, size));
+
+	if (rect.Area() <= 0
+		|| rect.Area() > g_RetainerDirtyRegionThreshold * size.X * size.Y)
+	{
+		return {};
+	}
+
+	return rect;
+}
+
 auto SRWA_RetainerWidget::PaintRetainedContentImpl(
 	FSlateInvalidationContext const& ctx,
 	FGeometry const& geo,
@@ -359,9 +716,20 @@ auto SRWA_RetainerWidget::PaintRetainedContentImpl(
 		&& m_LastTickedFrame != GFrameCounter
 		&& (GFrameCounter % m_PhaseCount) == m_Phase)
 	{
-		// If doing some phase based invalidation, just redraw everything again
-		m_RenderRequested = true;
-		InvalidateRootLayout();
+		// If doing some phase based invalidation, just redraw everything again.
+		// In adaptive mode, let the fast path repaint only what was invalidated
+		// instead, so the result tells us whether anything changed. When only
+		// some regions were invalidated, the phase just lets them draw.
+		if (m_DirtyRegion.IsSet() && !m_FullRedrawRequested) {
+			m_RenderRequested = true;
+		}
+		else if (!m_AdaptivePhase) {
+			RequestFullRedraw();
+		}
+		else {
+			m_RenderRequested = true;
+			m_FullRedrawRequested = true;
+		}
 	}
 
 	FPaintGeometry paintGeo = geo.ToPaintGeometry();
@@ -372,7 +740,9 @@ auto SRWA_RetainerWidget::PaintRetainedContentImpl(
 	// UE_LOG(LogTemp, Log, TEXT("Local Size:  %f x %f"), localSize.X, localSize.Y);
 	// UE_LOG(LogTemp, Log, TEXT("Scale 2D:    %f x %f"), scale2d.X, scale2d.Y);
 
-	FVector2f renderSize = localSize * scale2d;
+	m_AppliedRenderScale = GetEffectiveRenderScale();
+
+	FVector2f renderSize = localSize * scale2d * m_AppliedRenderScale;
 	// UE_LOG(LogTemp, Log, TEXT("Render Size: %f x %f"), renderSize.X, renderSize.Y);
 
 	FIntPoint renderSizeRounded = renderSize.IntPoint();
@@ -398,7 +768,7 @@ auto SRWA_RetainerWidget::PaintRetainedContentImpl(
 			m_PrevClipRectSize = clipRectSize;
 			m_PrevClippingState = clippingState;
 
-			InvalidateRootLayout();
+			RequestFullRedraw();
 		}
 
 		// Aggressively re-paint when a base state changes
@@ -413,24 +783,38 @@ auto SRWA_RetainerWidget::PaintRetainedContentImpl(
 	}
 	else if (renderSizeRounded != m_PrevRenderSize)
 	{
-		m_RenderRequested = true;
-		InvalidateRootLayout();
+		RequestFullRedraw();
 		m_PrevRenderSize = renderSizeRounded;
 	}
 
+	// Skip paint if it was not requested or our child widget is invisible
+	if (!m_RenderRequested || !m_Widget->GetVisibility().IsVisible()) {
+		s_WaitingToRender.Remove(this);
+		m_WaitStartTime = -1;
+
+		++m_Stats.NumSkipped;
+		INC_DWORD_STAT(STAT_RWA_RetainerSkipped);
+		CSV_CUSTOM_STAT(RWARetainers, Skipped, 1, ECsvCustomStatOp::Accumulate);
+
+		return EPaintRetainedContentResult::NotPainted;
+	}
+
 	// Defer work if we're over the frame budget
-	if (s_MaxRetainerWorkPerFrame > 0
-		&& s_RetainerWorkThisFrame.TryGetValue(0) > s_MaxRetainerWorkPerFrame)
-	{
+	double const now = FApp::GetCurrentTime();
+	if (m_WaitStartTime < 0)
+		m_WaitStartTime = now;
+
+	if (!HasBudgetToDraw(now)) {
 		s_WaitingToRender.AddUnique(this);
+		m_LastQueuedFrame = GFrameCounter;
+
+		++m_Stats.NumQueued;
+		INC_DWORD_STAT(STAT_RWA_RetainerQueued);
+		CSV_CUSTOM_STAT(RWARetainers, Queued, 1, ECsvCustomStatOp::Accumulate);
 
 		return EPaintRetainedContentResult::Queued;
 	}
 
-	// Skip paint if it was not requested or our child widget is invisible
-	if (!m_RenderRequested || !m_Widget->GetVisibility().IsVisible())
-		return EPaintRetainedContentResult::NotPainted;
-
 	// In order to get material parameter collections to function properly, we
 	// need the current world's Scene properly propagated through to any
 	// widgets that depend on that functionality. The SceneViewport and
@@ -443,13 +827,10 @@ auto SRWA_RetainerWidget::PaintRetainedContentImpl(
 	else if (IsInGameThread())
 		FSlateApplication::Get().GetRenderer()->RegisterCurrentScene(nullptr);
 
-	// Update the number of retainers we've drawn this frame
-	s_RetainerWorkThisFrame = s_RetainerWorkThisFrame.TryGetValue(0) + 1;
-
 	m_LastTickedFrame = GFrameCounter;
 
 	// Size must be a positive integer to allocate the RenderTarget
-	// TODO: This is where we're setting the RT size with viewport scale already applied
+	// This already includes the viewport scale and our render scale
 	uint32 rtWidth  = FMath::RoundToInt(FMath::Abs(renderSize.X));
 	uint32 rtHeight = FMath::RoundToInt(FMath::Abs(renderSize.Y));
 
@@ -475,46 +856,494 @@ auto SRWA_RetainerWidget::PaintRetainedContentImpl(
 		return EPaintRetainedContentResult::TextureSizeZero;
 	}
 
-	UTextureRenderTarget2D* rt = m_RenderResources->RenderTarget;
+	UTextureRenderTarget2D* rt = UpdateRenderTarget(FIntPoint(rtWidth, rtHeight));
+	if (!rt)
+		return EPaintRetainedContentResult::Queued;
+
+	if (!m_RenderResources->WidgetRenderer)
+		UpdateWidgetRenderer();
+
 	FWidgetRenderer* wr = m_RenderResources->WidgetRenderer;
 
-	// Handle size mismatch
-	if ((int32)rt->GetSurfaceWidth() != (int32)rtWidth
-		|| (int32)rt->GetSurfaceHeight() != (int32)rtHeight)
-	{
-		// If the render target resource already exists, just resize it. Calling
-		// InitCustomFormat flushes render commands which could result in a huge
-		// hitch.
-		if (rt->GameThread_GetRenderTargetResource()
-			&& rt->OverrideFormat == PF_B8G8R8A8)
-		{
-			rt->ResizeTarget(rtWidth, rtHeight);
+	FVector2f const targetSize (rt->GetSurfaceWidth(), rt->GetSurfaceHeight());
+	bool const isSubRect = m_TargetRect.Size() != FIntPoint(targetSize.X, targetSize.Y);
+	bool const isShared = m_RenderResources->AtlasSlot.IsValid();
+
+	// The content is painted scaled about the window's origin, so its position
+	// in the window is scaled too
+	FVector2f const contentOrigin = xform.GetTranslation() * m_AppliedRenderScale;
+	m_ContentOrigin = contentOrigin;
+	m_ContentScale = scale2d * m_AppliedRenderScale;
+
+	// Update the surface brush to match the latest size and region. When the
+	// render scale is below 1, the box we draw it into stretches it back up.
+	m_SurfaceBrush.ImageSize = FVector2D(rtWidth, rtHeight);
+	m_SurfaceBrush.SetUVRegion(FBox2f(
+		FVector2f(m_TargetRect.Min) / targetSize,
+		FVector2f(m_TargetRect.Max) / targetSize));
+
+	// The prepass has run by now, so widgets that grew since they invalidated
+	// their region (like a readout gaining a digit) are covered in full
+	for (TWeakPtr<SWidget const> const& weakWidget : m_DirtyWidgets) {
+		if (TSharedPtr<SWidget const> widget = weakWidget.Pin()) {
+			FVector2f const size = FVector2f(widget->GetPaintSpaceGeometry().GetLocalSize());
+			AddWidgetDirtyRegion(*widget, FVector2f::Max(size, FVector2f(widget->GetDesiredSize())));
 		}
-		else
-		{
-			bool forceLinearGamma = false;
-			rt->InitCustomFormat(rtWidth, rtHeight, PF_B8G8R8A8, forceLinearGamma);
-			rt->UpdateResourceImmediate();
+	}
+
+	TOptional<FIntRect> const dirtyRect = GetDirtyRect(FIntPoint(rtWidth, rtHeight));
+
+	// When we only own part of the render target, or only need to redraw part
+	// of our content, clear just that part
+	wr->SetShouldClearTarget(!isShared && !dirtyRect.IsSet());
+
+	bool skipDraw = false;
+
+	if (dirtyRect.IsSet()) {
+		FIntRect const& dirty = dirtyRect.GetValue();
+		FRWA_RetainerAtlasPool::ClearRegion(rt, dirty + m_TargetRect.Min);
+
+		// Clipping the content to the dirty region culls everything outside of
+		// it. The clip is pushed by PaintSlowPath, so take the slow path for
+		// this draw, but without invalidating the layout (and prepass).
+		m_ContentClipRect = FSlateRect(
+			contentOrigin + FVector2f(dirty.Min),
+			contentOrigin + FVector2f(dirty.Max));
+
+		SetNeedsSlowPath(true);
+		m_ContentCacheClipped = true;
+	}
+	else {
+		// The cached draw elements were clipped to the last dirty region, so the
+		// fast path would only replay that region. Repaint them all once.
+		if (m_ContentCacheClipped) {
+			SetNeedsSlowPath(true);
+			m_ContentCacheClipped = false;
+		}
+
+		// Clearing our slot throws its content away, so the draw has to repaint
+		// all of it. The fast path draws nothing when no widget was invalidated,
+		// so only clear when something was, and take the slow path.
+		if (isShared) {
+			if (NeedsSlowPath() || m_ContentInvalidated) {
+				FRWA_RetainerAtlasPool::ClearRegion(rt, m_TargetRect);
+				SetNeedsSlowPath(true);
+			}
+			else {
+				skipDraw = true;
+			}
 		}
+
+		// Either way, clip the content to its region so nothing spills over
+		// into our neighbours (or outside the UV region when filtering)
+		if (isSubRect)
+			m_ContentClipRect = FSlateRect(contentOrigin, contentOrigin + FVector2f(rtWidth, rtHeight));
+		else
+			m_ContentClipRect.Reset();
 	}
 
-	// Update the surface brush to match the latest size
-	m_SurfaceBrush.ImageSize = FVector2D(rtWidth, rtHeight);
+	wr->ViewOffset = FVector2D(-contentOrigin + FVector2f(m_TargetRect.Min));
+
+	double const drawStart = FPlatformTime::Seconds();
+
+	bool repainted = false;
+	if (!skipDraw) {
+		SCOPE_CYCLE_COUNTER(STAT_RWA_RetainerWidgetDraw);
+		STAT(FScopeCycleCounter drawCycleCounter(m_DrawStatId));
+
+		repainted = wr->DrawInvalidationRoot(m_VirtualWindow, rt, *this, ctx, false);
+	}
 
-	wr->ViewOffset = -xform.GetTranslation();
+	// Charge the time actually spent to this frame's budget
+	double const drawTime = (FPlatformTime::Seconds() - drawStart) * 1e6;
+	s_RetainerTimeThisFrame = s_RetainerTimeThisFrame.TryGetValue(0) + drawTime;
+	m_DrawCost = m_DrawCost > 0
+		? FMath::Lerp(m_DrawCost, drawTime, 0.25)
+		: drawTime;
+
+	m_Stats.DrawTime = drawTime;
+	CSV_CUSTOM_STAT(RWARetainers, DrawTime, (float)(drawTime / 1000), ECsvCustomStatOp::Accumulate);
+#if CSV_PROFILER
+	if (!m_StatName.IsNone()) {
+		FCsvProfiler::RecordCustomStat(
+			m_StatName,
+			CSV_CATEGORY_INDEX(RWARetainers),
+			(float)(drawTime / 1000),
+			ECsvCustomStatOp::Accumulate);
+	}
+#endif
+
+	if (repainted) {
+		++m_Stats.NumRedraws;
+		INC_DWORD_STAT(STAT_RWA_RetainerRedraws);
+		CSV_CUSTOM_STAT(RWARetainers, Redraws, 1, ECsvCustomStatOp::Accumulate);
+	}
+	else {
+		++m_Stats.NumSkipped;
+		INC_DWORD_STAT(STAT_RWA_RetainerSkipped);
+		CSV_CUSTOM_STAT(RWARetainers, Skipped, 1, ECsvCustomStatOp::Accumulate);
+	}
 
-	bool repainted = wr->DrawInvalidationRoot(m_VirtualWindow, rt, *this, ctx, false);
+	if (m_AdaptivePhase && m_RenderOnPhase)
+		UpdateAdaptivePhase(repainted);
 
 	m_RenderRequested = false;
+	m_FullRedrawRequested = false;
+	m_ContentInvalidated = false;
+	m_DirtyRegion.Reset();
+	m_DirtyWidgets.Reset();
 	s_WaitingToRender.Remove(this);
 	// FIXME: Should LastDrawTime be updated if `repainted` is false?
-	m_LastDrawTime = FApp::GetCurrentTime();
+	m_LastDrawTime = now;
+	m_WaitStartTime = -1;
 
 	return repainted
 		? EPaintRetainedContentResult::Painted
 		: EPaintRetainedContentResult::NotPainted;
 }
 
+double SRWA_RetainerWidget::GetDrawScore(double now) const
+{
+	// Priority-weighted age: higher priorities go first, but anything that's
+	// waited long enough will eventually outrank them
+	return m_Priority * (now - m_LastDrawTime);
+}
+
+bool SRWA_RetainerWidget::HasBudgetToDraw(double now) const
+{
+	if (g_RetainerFrameBudget <= 0)
+		return true;
+
+	// Staleness is how long this draw has been waiting, not how long ago the
+	// last one was, or anything that draws rarely would skip the budget
+	if (g_RetainerMaxStaleness > 0 && now - m_WaitStartTime >= g_RetainerMaxStaleness)
+		return true;
+
+	// Set aside time for every retainer that was queued ahead of us and is
+	// still waiting, since Slate's paint order has nothing to do with priority
+	double const score = GetDrawScore(now);
+	double reserved = 0;
+
+	for (int32 i = s_WaitingToRender.Num() - 1; i >= 0; --i) {
+		Self const* other = s_WaitingToRender[i];
+
+		// Anything not queued last frame has been hidden or removed from the tree
+		if (other->m_LastQueuedFrame < (int64)GFrameCounter - 1) {
+			s_WaitingToRender.RemoveAtSwap(i);
+			continue;
+		}
+
+		if (other != this && other->GetDrawScore(now) > score)
+			reserved += other->m_DrawCost;
+	}
+
+	double const spent = s_RetainerTimeThisFrame.TryGetValue(0);
+
+	// The first retainer of the frame always gets to draw, so a single panel
+	// that costs more than the whole budget can't stall forever
+	if (spent == 0 && reserved == 0)
+		return true;
+
+	return spent + reserved + m_DrawCost <= g_RetainerFrameBudget;
+}
+
+UTextureRenderTarget2D* SRWA_RetainerWidget::UpdateRenderTarget(FIntPoint size)
+{
+	FRWA_RetainerAtlasPool& atlas = FRWA_RetainerAtlasPool::Get();
+	FRWA_RetainerAtlasSlot& slot = m_RenderResources->AtlasSlot;
+
+	EPixelFormat const format = GetPixelFormat();
+
+	if (m_UseSharedAtlas) {
+		FRWA_RetainerAtlasSlot const prevSlot = slot;
+
+		if (atlas.Allocate(size, format, slot)) {
+			// A new slot has none of our content in it
+			if (slot.Page != prevSlot.Page || slot.Rect != prevSlot.Rect) {
+				RecordResize();
+				RequestFullRedraw();
+			}
+
+			FIntPoint const origin = slot.GetContentOrigin();
+			m_TargetRect = FIntRect(origin, origin + size);
+
+			// Null if the slot is on a new page, which only gets its render target
+			// at the end of the frame
+			return atlas.GetRenderTarget(slot.Page);
+		}
+	}
+
+	// Not using the atlas, or too big to fit in it -- use our own render target
+	atlas.Release(slot);
+
+	UTextureRenderTarget2D* rt = GetOrCreateRenderTarget();
+
+	// The render target is allocated in buckets, and the content is drawn into
+	// its top-left corner, so most size changes don't need a new allocation
+	FIntPoint const allocated (rt->GetSurfaceWidth(), rt->GetSurfaceHeight());
+	FIntPoint const bucket = GetBucketedSize(size);
+
+	bool const fits = size.X <= allocated.X && size.Y <= allocated.Y;
+	bool const wasteful = (int64)bucket.X * bucket.Y * 2 < (int64)allocated.X * allocated.Y;
+
+	if (!fits || wasteful) {
+		if (allocated.X == 0 || allocated.Y == 0 || !rt->GameThread_GetRenderTargetResource()) {
+			// Nothing to show until we have a render target, so there's no point
+			// in waiting
+			ResizeRenderTarget(rt, bucket, format);
+			RecordResize();
+			RequestFullRedraw();
+		}
+		else {
+			// Reallocating can flush the render thread, so hold off until the end
+			// of the frame. Until then, a target that's grown too small keeps
+			// showing its last image.
+			if (m_PendingTargetSize == FIntPoint::NoneValue)
+				s_PendingResizes.Add(this);
+
+			m_PendingTargetSize = bucket;
+
+			if (!fits)
+				return nullptr;
+		}
+	}
+
+	// Changing formats can't wait for the end of the frame, since the old
+	// target no longer matches what the effect material expects
+	if (rt->OverrideFormat != format) {
+		ResizeRenderTarget(rt, fits && !wasteful ? allocated : bucket, format);
+		RecordResize();
+		RequestFullRedraw();
+	}
+
+	m_TargetRect = FIntRect(FIntPoint::ZeroValue, size);
+
+	return rt;
+}
+
+UTextureRenderTarget2D* SRWA_RetainerWidget::GetOrCreateRenderTarget()
+{
+	if (UTextureRenderTarget2D* rt = m_RenderResources->RenderTarget)
+		return rt;
+
+	UTextureRenderTarget2D* rt = FRWA_RetainerAtlasPool::Get().TakeRenderTarget(GetPixelFormat());
+	if (!rt) {
+		rt = NewObject<UTextureRenderTarget2D>();
+		rt->ClearColor = FLinearColor::Transparent;
+		rt->RenderTargetFormat = RTF_RGBA8_SRGB;
+	}
+
+	m_RenderResources->RenderTarget = rt;
+
+	// Match the render target to our gamma settings
+	UpdateWidgetRenderer();
+
+	return rt;
+}
+
+bool SRWA_RetainerWidget::HasRenderResources() const
+{
+	return m_RenderResources->WidgetRenderer
+		|| m_RenderResources->RenderTarget
+		|| m_RenderResources->AtlasSlot.IsValid();
+}
+
+void SRWA_RetainerWidget::ReleaseRenderResources()
+{
+	RenderResources* released = m_RenderResources;
+
+	FRWA_RetainerAtlasPool& pool = FRWA_RetainerAtlasPool::Get();
+	pool.Release(released->AtlasSlot);
+
+	if (g_RetainerPoolReleasedTargets) {
+		pool.ReturnRenderTarget(released->RenderTarget);
+		released->RenderTarget = nullptr;
+	}
+
+	// The effect material belongs to the widget, not the render target
+	m_RenderResources = new RenderResources;
+	m_RenderResources->DynamicEffect = released->DynamicEffect;
+
+	if (UMaterialInstanceDynamic* effect = m_RenderResources->DynamicEffect)
+		effect->SetTextureParameterValue(m_DynamicEffectTextureParam, nullptr);
+	else
+		m_SurfaceBrush.SetResourceObject(nullptr);
+
+	// The render thread may still be using these, so they're deleted when safe
+	BeginCleanup(released);
+
+	s_PendingResizes.Remove(this);
+	m_PendingTargetSize = FIntPoint::NoneValue;
+
+	// Everything will need to be drawn again from scratch
+	m_PrevRenderSize = FIntPoint::NoneValue;
+	RequestFullRedraw();
+}
+
+bool SRWA_RetainerWidget::ReleaseIdleRenderResources(float deltaTime)
+{
+	if (g_RetainerReleaseIdleTime <= 0)
+		return true;
+
+	double const now = FApp::GetCurrentTime();
+
+	for (Self* retainer : s_LiveRetainers) {
+		if (now - retainer->m_LastPaintTime >= g_RetainerReleaseIdleTime
+			&& retainer->HasRenderResources())
+		{
+			retainer->ReleaseRenderResources();
+		}
+	}
+
+	return true;
+}
+
+FIntPoint SRWA_RetainerWidget::GetBucketedSize(FIntPoint size)
+{
+	int32 const maxSize = (int32)GetMax2DTextureDimension();
+
+	auto bucketed = [maxSize](int32 value) -> int32
+	{
+		int32 result = g_RetainerTargetBucketSize > 0
+			? Align(value, g_RetainerTargetBucketSize)
+			: (int32)FMath::RoundUpToPowerOfTwo((uint32)value);
+
+		return FMath::Clamp(result, value, FMath::Max(value, maxSize));
+	};
+
+	return { bucketed(size.X), bucketed(size.Y) };
+}
+
+void SRWA_RetainerWidget::ResizeRenderTarget(
+	UTextureRenderTarget2D* rt,
+	FIntPoint size,
+	EPixelFormat format)
+{
+	// If the render target resource already exists, just resize it. Calling
+	// InitCustomFormat flushes render commands which could result in a huge
+	// hitch. Deferring this to the end of the frame doesn't avoid that when
+	// the format changes; the size buckets are what keep it rare.
+	if (rt->GameThread_GetRenderTargetResource()
+		&& rt->OverrideFormat == format)
+	{
+		rt->ResizeTarget(size.X, size.Y);
+	}
+	else
+	{
+		bool forceLinearGamma = false;
+		rt->InitCustomFormat(size.X, size.Y, format, forceLinearGamma);
+		rt->UpdateResourceImmediate();
+	}
+}
+
+void SRWA_RetainerWidget::ApplyPendingResizes()
+{
+	FRWA_RetainerAtlasPool::Get().ApplyPendingPages();
+
+	for (Self* retainer : s_PendingResizes) {
+		ResizeRenderTarget(
+			retainer->m_RenderResources->RenderTarget,
+			retainer->m_PendingTargetSize,
+			retainer->GetPixelFormat());
+		retainer->m_PendingTargetSize = FIntPoint::NoneValue;
+		retainer->RecordResize();
+
+		// The old contents are gone, so redraw everything
+		retainer->RequestFullRedraw();
+	}
+
+	s_PendingResizes.Reset();
+}
+
+
+// Stats -----------------------------------------------------------------------
+
+void SRWA_RetainerWidget::RecordResize()
+{
+	++m_Stats.NumResizes;
+	INC_DWORD_STAT(STAT_RWA_RetainerResizes);
+	CSV_CUSTOM_STAT(RWARetainers, Resizes, 1, ECsvCustomStatOp::Accumulate);
+}
+
+int64 SRWA_RetainerWidget::GetRenderTargetBytes() const
+{
+	FIntPoint size;
+	EPixelFormat format;
+
+	if (m_RenderResources->AtlasSlot.IsValid()) {
+		// Our share of the page, including the padding around our slot
+		size = m_RenderResources->AtlasSlot.Rect.Size();
+		format = GetPixelFormat();
+	}
+	else if (UTextureRenderTarget2D const* rt = m_RenderResources->RenderTarget) {
+		size = FIntPoint(rt->SizeX, rt->SizeY);
+		format = rt->OverrideFormat;
+	}
+	else {
+		return 0;
+	}
+
+	return (int64)size.X * size.Y * GPixelFormats[format].BlockBytes;
+}
+
+FString SRWA_RetainerWidget::GetDebugName() const
+{
+	return m_StatName.IsNone()
+		? ToString()
+		: m_StatName.ToString();
+}
+
+void SRWA_RetainerWidget::PublishFrameStats()
+{
+#if STATS || CSV_PROFILER
+	int64 bytes = 0;
+	for (Self const* retainer : s_LiveRetainers)
+		bytes += retainer->GetRenderTargetBytes();
+
+	SET_MEMORY_STAT(STAT_RWA_RetainerTargetMemory, bytes);
+	CSV_CUSTOM_STAT(RWARetainers, TargetMemoryMB, (float)(bytes / (1024.0 * 1024.0)), ECsvCustomStatOp::Set);
+#endif
+}
+
+void SRWA_RetainerWidget::DumpLiveRetainers(FOutputDevice& ar)
+{
+	TArray<Self const*> sorted (s_LiveRetainers);
+	sorted.Sort([](Self const& lhs, Self const& rhs) -> bool {
+		return lhs.m_DrawCost > rhs.m_DrawCost;
+	});
+
+	ar.Logf(TEXT("%d live RWA retainer widgets, most expensive first:"), sorted.Num());
+
+	int64 totalBytes = 0;
+	for (Self const* retainer : sorted) {
+		FRWA_RetainerStats const& stats = retainer->m_Stats;
+		FIntPoint const size = retainer->m_TargetRect.Size();
+		int64 const bytes = retainer->GetRenderTargetBytes();
+		totalBytes += bytes;
+
+		ar.Logf(
+			TEXT("  %s%s: %dx%d %s%s, %.1f KiB | paint %.1f us, draw %.1f us (avg %.1f us) "
+				"| %lld redraws, %lld skipped, %lld queued, %lld resizes | phase %d/%d"),
+			*retainer->GetDebugName(),
+			retainer->m_EnableRetainedRendering ? TEXT("") : TEXT(" (not retained)"),
+			size.X, size.Y,
+			GPixelFormats[retainer->GetPixelFormat()].Name,
+			retainer->m_RenderResources->AtlasSlot.IsValid() ? TEXT(" (shared)") : TEXT(""),
+			bytes / 1024.0,
+			stats.PaintTime,
+			stats.DrawTime,
+			retainer->m_DrawCost,
+			stats.NumRedraws,
+			stats.NumSkipped,
+			stats.NumQueued,
+			stats.NumResizes,
+			retainer->m_Phase,
+			retainer->m_PhaseCount);
+	}
+
+	ar.Logf(TEXT("Total render target memory: %.1f KiB"), totalBytes / 1024.0);
+}
+
 int32 SRWA_RetainerWidget::OnPaint(
 	FPaintArgs const& args,
 	FGeometry const& geo,
@@ -540,31 +1369,47 @@ int32 SRWA_RetainerWidget::OnPaint(
 	SCOPE_CYCLE_COUNTER(STAT_RWA_RetainerWidgetPaint);
 	
 	Self* self_mut = const_cast<Self*>(this);
+	self_mut->m_LastPaintTime = FApp::GetCurrentTime();
+
+	double const paintStart = FPlatformTime::Seconds();
+	ON_SCOPE_EXIT {
+		double const paintTime = (FPlatformTime::Seconds() - paintStart) * 1e6;
+		self_mut->m_Stats.PaintTime = paintTime;
+		CSV_CUSTOM_STAT(RWARetainers, PaintTime, (float)(paintTime / 1000), ECsvCustomStatOp::Accumulate);
+	};
 
-	// Copy hit-test grid settings from the root
+	FPaintArgs args_new = args.WithNewHitTestGrid(m_HitTestGrid.Get());
 
-	// FIXME: FPaintArgs declares SRetainerWidget as a friend class so that it's
-	// able to access its private members directly. We don't have that luxury
-	// here in userland, so we have to do this sketchy bullshit instead. If the
-	// type or offset of FPaintArgs::RootGrid ever changes, this is going to be a
-	// nightmare to debug.
-	FHittestGrid const& rootGrid = **(FHittestGrid**)&args;
+	if (m_HitTestable) {
+		// Copy hit-test grid settings from the root
 
-	if (m_HitTestGrid->SetHittestArea(
-		rootGrid.GetGridOrigin(),
-		rootGrid.GetGridSize(),
-		rootGrid.GetGridWindowOrigin()))
-	{
-		self_mut->RequestRender();
-	}
+		// FIXME: FPaintArgs declares SRetainerWidget as a friend class so that
+		// it's able to access its private members directly. We don't have that
+		// luxury here in userland, so we have to do this sketchy bullshit
+		// instead. If the type or offset of FPaintArgs::RootGrid ever changes,
+		// this is going to be a nightmare to debug.
+		FHittestGrid const& rootGrid = **(FHittestGrid**)&args;
+
+		if (m_HitTestGrid->SetHittestArea(
+			rootGrid.GetGridOrigin(),
+			rootGrid.GetGridSize(),
+			rootGrid.GetGridWindowOrigin()))
+		{
+			self_mut->RequestRender();
+		}
 
-	m_HitTestGrid->SetOwner(this);
-	m_HitTestGrid->SetCullingRect(cullingRect);
+		m_HitTestGrid->SetOwner(this);
+		m_HitTestGrid->SetCullingRect(cullingRect);
 
-	FPaintArgs args_new = args.WithNewHitTestGrid(m_HitTestGrid.Get());
-	// Copy the current user index into the new grid since nested hittest grids
-	// should inherit their parent's user id
-	args_new.GetHittestGrid().SetUserIndex(rootGrid.GetUserIndex());
+		// Copy the current user index into the new grid since nested hittest
+		// grids should inherit their parent's user id
+		args_new.GetHittestGrid().SetUserIndex(rootGrid.GetUserIndex());
+	}
+	else {
+		// The nested grid is still passed down (and left empty) so the content
+		// can't register itself in the root grid
+		args_new.SetInheritedHittestability(false);
+	}
 
 	FSlateInvalidationContext ctx (out_drawElements, style);
 	ctx.bParentEnabled = parentEnabled;
@@ -598,10 +1443,9 @@ int32 SRWA_RetainerWidget::OnPaint(
 	if (paintResult == EPaintRetainedContentResult::TextureSizeZero)
 		return GetCachedMaxLayerId();
 
-	UTextureRenderTarget2D* rt = m_RenderResources->RenderTarget;
-	check(rt);
+	UTextureRenderTarget2D* rt = m_RenderResources->GetTarget();
 
-	if (rt->GetSurfaceWidth() >= 1.f && rt->GetSurfaceHeight() >= 1.f) {
+	if (rt && rt->GetSurfaceWidth() >= 1.f && rt->GetSurfaceHeight() >= 1.f) {
 		FLinearColor computedColorAndOpacity =
 			ctx.WidgetStyle.GetColorAndOpacityTint()
 				* GetColorAndOpacity()
@@ -611,6 +1455,8 @@ int32 SRWA_RetainerWidget::OnPaint(
 		
 		if (UMaterialInstanceDynamic* effect = m_RenderResources->DynamicEffect)
 			effect->SetTextureParameterValue(m_DynamicEffectTextureParam, rt);
+		else if (m_SurfaceBrush.GetResourceObject() != rt)
+			m_SurfaceBrush.SetResourceObject(rt);
 
 		FSlateDrawElement::MakeBox(
 			*ctx.WindowElementList,
@@ -624,7 +1470,8 @@ int32 SRWA_RetainerWidget::OnPaint(
 	}
 
 	// Add our widgets to the root hit-test grid
-	args.GetHittestGrid().AddGrid(m_HitTestGrid);
+	if (m_HitTestable)
+		args.GetHittestGrid().AddGrid(m_HitTestGrid);
 
 	return GetCachedMaxLayerId();
 }
@@ -648,7 +1495,7 @@ bool SRWA_RetainerWidget::CustomPrepass(float layoutScaleMultiplier)
 	if (!m_EnableRetainedRendering)
 		return true;
 
-	ProcessInvalidation();
+	m_ContentInvalidated |= ProcessInvalidation();
 
 	if (NeedsSlowPath()) {
 		FChildren* children = Super::GetChildren();
@@ -668,34 +1515,38 @@ TSharedRef<SWidget> SRWA_RetainerWidget::GetRootWidget()
 
 int32 SRWA_RetainerWidget::PaintSlowPath(FSlateInvalidationContext const& ctx) 
 {
+	FGeometry geo = GetPaintSpaceGeometry();
+
 	if (m_EnableRenderWithLocalTransform && g_SlateEnableRenderWithLocalTransform) {
-		FGeometry geo = GetPaintSpaceGeometry();
+		float const renderScale = m_AppliedRenderScale;
 		FSlateRenderTransform simplifiedXform {
-			geo.GetAccumulatedRenderTransform().GetMatrix().GetScale(),
-			geo.GetAccumulatedRenderTransform().GetTranslation(),
+			FScale2f(geo.GetAccumulatedRenderTransform().GetMatrix().GetScale().GetVector() * renderScale),
+			geo.GetAccumulatedRenderTransform().GetTranslation() * renderScale,
 		};
 
-		FGeometry const geo_new =
-			FGeometry::MakeRoot(geo.GetLocalSize(), FSlateLayoutTransform())
-				.MakeChild(simplifiedXform, FVector2D::ZeroVector);
-
-		return Super::OnPaint(
-			*ctx.PaintArgs,
-			geo_new,
-			ctx.CullingRect,
-			*ctx.WindowElementList,
-			ctx.IncomingLayerId,
-			ctx.WidgetStyle,
-			ctx.bParentEnabled);
+		geo = FGeometry::MakeRoot(geo.GetLocalSize(), FSlateLayoutTransform())
+			.MakeChild(simplifiedXform, FVector2D::ZeroVector);
 	}
 
-	return Super::OnPaint(
+	if (m_ContentClipRect.IsSet())
+		ctx.WindowElementList->PushClip(FSlateClippingZone(m_ContentClipRect.GetValue()));
+
+	// Cull to the clip too, so a dirty region draw skips everything outside it
+	FSlateRect const cullingRect = m_ContentClipRect.IsSet()
+		? ctx.CullingRect.IntersectionWith(m_ContentClipRect.GetValue())
+		: ctx.CullingRect;
+
+	int32 maxLayerId = Super::OnPaint(
 		*ctx.PaintArgs,
-		GetPaintSpaceGeometry(),
-		ctx.CullingRect,
+		geo,
+		cullingRect,
 		*ctx.WindowElementList,
 		ctx.IncomingLayerId,
 		ctx.WidgetStyle,
 		ctx.bParentEnabled);
-}
 
+	if (m_ContentClipRect.IsSet())
+		ctx.WindowElementList->PopClip();
+
+	return maxLayerId;
+}
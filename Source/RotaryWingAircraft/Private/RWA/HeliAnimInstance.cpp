@@ -2,42 +2,182 @@
 
 #include "RWA/Heli.h"
 #include "RWA/HeliMovement.h"
+#include "SignificanceManager.h"
 
 
 // Animation Data --------------------------------------------------------------
 
 FRWA_RotorAnimData::FRWA_RotorAnimData(FRWA_RotorSetup const& rotor)
 	: BoneName(rotor.BoneName)
-	, TorqueNormal(rotor.TorqueNormal)
-{}
+	, TorqueNormal(rotor.TorqueNormal.GetSafeNormal())
+	, GearRatio(rotor.GearRatio)
+	, BlurRPM(rotor.BlurRPM)
+	, BlurParameter(rotor.BlurParameter)
+	, CounterRotating(rotor.CounterRotating)
+	, Linkage(rotor.Linkage)
+{
+	Linkage.BladeSpanAxis = Linkage.BladeSpanAxis.GetSafeNormal();
+
+	if (BlurParameter == EName::None && BoneName != EName::None)
+		BlurParameter = FName(BoneName.ToString() + TEXT("Blur"));
+}
 
 
 // Animation instance proxy ----------------------------------------------------
 
-void FRWA_HeliAnimInstanceProxy::SetMovementComponent(URWA_HeliMovementComponent const* mc)
+void FRWA_HeliAnimInstanceProxy::SetRotorSetup(TArray<FRWA_RotorSetup> const& rotors)
 {
-	TArray<FRWA_RotorSetup> const& rotors = mc->Rotors;
-	m_RotorInstances.Empty(rotors.Num());
+	int32 len = rotors.Num();
+	int32 paddedLen = Align(len, 4);
 
-	for (FRWA_RotorSetup const& rotor : rotors)
+	m_RotorInstances.Empty(len);
+	m_LinkageStates.Init({}, len);
+	m_RotorRates.Reset(paddedLen);
+	m_RotorAngles.Reset(paddedLen);
+
+	for (FRWA_RotorSetup const& rotor : rotors) {
 		m_RotorInstances.Add({ rotor });
+
+		float direction = rotor.CounterRotating ? 1.f : -1.f;
+		m_RotorRates.Add(k_RpmToRadsPerSec * rotor.GearRatio * direction);
+		m_RotorAngles.Add(FMath::DegreesToRadians(rotor.PhaseOffset));
+	}
+
+	m_RotorRates.SetNumZeroed(paddedLen);
+	m_RotorAngles.SetNumZeroed(paddedLen);
+	m_RotorSinHalf.SetNumZeroed(paddedLen);
+	m_RotorCosHalf.SetNumZeroed(paddedLen);
+
+	m_LastUpdateTime = -1;
+	m_LastRPM = 0;
+	UpdateRotors(0, 0);
 }
 
 void FRWA_HeliAnimInstanceProxy::PreUpdate(UAnimInstance* instance, float deltaTime)
 {
 	Super::PreUpdate(instance, deltaTime);
 
-	auto const* inst = CastChecked<URWA_HeliAnimInstance>(instance);
-	if (!inst) return;
+	// This is the only place the proxy reads from UObjects: everything the
+	// worker-thread update needs is copied here, on the game thread
+	m_Inputs = {};
 
-	URWA_HeliMovementComponent const* mc = inst->GetMovementComponent();
+	auto const* inst = CastChecked<URWA_HeliAnimInstance>(instance);
+	URWA_HeliMovementComponent const* mc = inst->m_MovementComponent;
 	if (!mc) return;
 
-	float deltaAngle = mc->GetCurrentRPM() * deltaTime * -k_RpmToRadsPerSec;
-	m_RotorAngle = FMath::Fmod(m_RotorAngle + deltaAngle, 2 * PI);
+	if (m_RotorSetupSerial != inst->m_RotorSetupSerial) {
+		SetRotorSetup(mc->Rotors);
+		m_RotorSetupSerial = inst->m_RotorSetupSerial;
+	}
+
+	m_Inputs.RPM = mc->GetCurrentRPM();
+	m_Inputs.NominalRPM = mc->RPM;
+	m_Inputs.Collective = mc->GetCurrentCollective();
+	m_Inputs.Cyclic = mc->GetCurrentCyclic();
+
+	if (UWorld const* world = instance->GetWorld())
+		m_Inputs.WorldTime = world->GetTimeSeconds();
+
+	m_Inputs.RotorUpdateInterval = inst->m_RotorUpdateInterval;
+	m_Inputs.RotorUpdatePhase = inst->m_RotorUpdatePhase;
+	m_Inputs.FrameCounter = GFrameCounter;
+
+	m_Inputs.IsValid = true;
+}
+
+void FRWA_HeliAnimInstanceProxy::Update(float deltaTime)
+{
+	Super::Update(deltaTime);
+
+	if (!m_Inputs.IsValid)
+		return;
+
+	// The rotor LOD, when it isn't throttling the whole mesh. Skipped frames are
+	// made up for by the elapsed time on the next update.
+	if (m_Inputs.RotorUpdateInterval > 1
+		&& (m_Inputs.FrameCounter + m_Inputs.RotorUpdatePhase) % m_Inputs.RotorUpdateInterval != 0)
+	{
+		return;
+	}
+
+	// Integrate over the world time that has actually elapsed since the last
+	// update, which may span several frames when the rotor LOD is skipping them
+	float elapsed = deltaTime;
+	if (m_Inputs.WorldTime >= 0) {
+		if (m_LastUpdateTime >= 0)
+			elapsed = static_cast<float>(m_Inputs.WorldTime - m_LastUpdateTime);
+
+		m_LastUpdateTime = m_Inputs.WorldTime;
+	}
+
+	float rpm = m_Inputs.RPM;
+	UpdateRotors((m_LastRPM + rpm) * 0.5f, elapsed);
+	m_LastRPM = rpm;
+
+	// A little hysteresis keeps the swap from flickering while the engine hovers
+	// around the threshold
+	for (FRWA_RotorAnimData& rotor : m_RotorInstances) {
+		float threshold = rotor.IsBlurred ? rotor.BlurRPM * k_BlurHysteresis : rotor.BlurRPM;
+		rotor.IsBlurred = rotor.BlurRPM > 0 && rpm * rotor.GearRatio >= threshold;
+	}
+
+	UpdateLinkages();
+}
+
+void FRWA_HeliAnimInstanceProxy::UpdateLinkages()
+{
+	float collective = FMath::Clamp(m_Inputs.Collective, -1.f, 1.f);
+	float rpmAlpha = m_Inputs.NominalRPM > 0
+		? FMath::Clamp(m_Inputs.RPM / m_Inputs.NominalRPM, 0.f, 1.f)
+		: 0.f;
+
+	// Tilt axis in component space, matching the torque applied by the movement
+	// component for the same cyclic input
+	FVector tilt = FVector::RightVector * m_Inputs.Cyclic.Y - FVector::ForwardVector * m_Inputs.Cyclic.X;
+	tilt = tilt.GetClampedToMaxSize(1);
+
+	for (int32 i = 0; i < m_RotorInstances.Num(); ++i) {
+		FRWA_RotorAnimData const& rotor = m_RotorInstances[i];
+		FRWA_RotorLinkageSetup const& setup = rotor.Linkage;
+		FRWA_RotorLinkageState& state = m_LinkageStates[i];
+
+		float tiltAngle = FMath::DegreesToRadians(setup.SwashplateMaxTilt) * tilt.Size();
+		state.SwashplateTilt = tiltAngle > 0 ? FQuat(tilt.GetUnsafeNormal(), tiltAngle) : FQuat::Identity;
+		state.SwashplateOffset = rotor.TorqueNormal * (collective * setup.SwashplateTravel);
+
+		// The tilted swashplate raises the pitch links of blades pointing along
+		// (normal x tilt axis). Blade pitch is mirrored for counter-rotating rotors.
+		float direction = rotor.CounterRotating ? -1.f : 1.f;
+		state.CollectivePitch = direction * collective * FMath::DegreesToRadians(setup.MaxCollectivePitch);
+		state.CyclicPitchAxis = (rotor.TorqueNormal ^ tilt) * (direction * FMath::DegreesToRadians(setup.MaxCyclicPitch));
+
+		// Stopped blades don't cone
+		state.ConingAngle = FMath::Max(collective, 0.f) * rpmAlpha * FMath::DegreesToRadians(setup.MaxConingAngle);
+	}
+}
+
+void FRWA_HeliAnimInstanceProxy::UpdateRotors(float rpm, float deltaTime)
+{
+	VectorRegister4Float const delta = VectorSetFloat1(rpm * deltaTime);
+	VectorRegister4Float const twoPi = VectorSetFloat1(UE_TWO_PI);
+	VectorRegister4Float const half = VectorSetFloat1(0.5f);
+
+	float* angles = m_RotorAngles.GetData();
+	float const* rates = m_RotorRates.GetData();
+	float* sinHalf = m_RotorSinHalf.GetData();
+	float* cosHalf = m_RotorCosHalf.GetData();
+
+	for (int32 i = 0; i < m_RotorAngles.Num(); i += 4) {
+		VectorRegister4Float angle = VectorMultiplyAdd(VectorLoadAligned(rates + i), delta, VectorLoadAligned(angles + i));
+		angle = VectorMod(angle, twoPi);
+		VectorStoreAligned(angle, angles + i);
 
-	for (FRWA_RotorAnimData& rotor : m_RotorInstances)
-		rotor.Rotation = FQuat(rotor.TorqueNormal, m_RotorAngle).Rotator();
+		VectorRegister4Float halfAngle = VectorMultiply(angle, half);
+		VectorRegister4Float s, c;
+		VectorSinCos(&s, &c, &halfAngle);
+		VectorStoreAligned(s, sinHalf + i);
+		VectorStoreAligned(c, cosHalf + i);
+	}
 }
 
 TArray<FRWA_RotorAnimData> const& FRWA_HeliAnimInstanceProxy::GetAnimData() const 
@@ -45,13 +185,23 @@ TArray<FRWA_RotorAnimData> const& FRWA_HeliAnimInstanceProxy::GetAnimData() cons
 	return m_RotorInstances;
 }
 
+FRWA_HeliAnimInputs const& FRWA_HeliAnimInstanceProxy::GetInputs() const
+{
+	return m_Inputs;
+}
+
+FRWA_RotorLinkageState const& FRWA_HeliAnimInstanceProxy::GetLinkageState(int32 idx) const
+{
+	return m_LinkageStates[idx];
+}
+
 
 // Animation instance ----------------------------------------------------------
 
 void URWA_HeliAnimInstance::SetMovementComponent(URWA_HeliMovementComponent const* mc)
 {
 	m_MovementComponent = mc;
-	m_Proxy.SetMovementComponent(mc);
+	++m_RotorSetupSerial;
 }
 
 URWA_HeliMovementComponent const* URWA_HeliAnimInstance::GetMovementComponent() const
@@ -69,12 +219,184 @@ void URWA_HeliAnimInstance::NativeInitializeAnimation()
 	if (AActor* actor = GetOwningActor())
 		if (auto* mc = actor->FindComponentByClass<URWA_HeliMovementComponent>())
 			SetMovementComponent(mc);
+
+	// Re-initialized after BeginPlay (e.g. the anim class or mesh changed), so
+	// NativeBeginPlay won't be called again to register us
+	UWorld const* world = GetWorld();
+	if (UseSignificance && world && world->HasBegunPlay())
+		RegisterSignificance();
 }
 
-FAnimInstanceProxy* URWA_HeliAnimInstance::CreateAnimInstanceProxy() 
+void URWA_HeliAnimInstance::NativeBeginPlay()
 {
-	return &m_Proxy;
+	Super::NativeBeginPlay();
+
+	if (UseSignificance)
+		RegisterSignificance();
 }
 
-void URWA_HeliAnimInstance::DestroyAnimInstanceProxy(FAnimInstanceProxy* proxy)
-{}
+void URWA_HeliAnimInstance::NativeUninitializeAnimation()
+{
+	UnregisterSignificance();
+
+	Super::NativeUninitializeAnimation();
+}
+
+void URWA_HeliAnimInstance::NativeUpdateAnimation(float deltaTime)
+{
+	Super::NativeUpdateAnimation(deltaTime);
+
+	ApplyRotorBlur();
+}
+
+
+// Rotor Blur ------------------------------------------------------------------
+
+void URWA_HeliAnimInstance::ApplyRotorBlur()
+{
+	USkeletalMeshComponent* mesh = GetSkelMeshComponent();
+	if (!mesh)
+		return;
+
+	// Waits for any in-flight worker-thread update before reading the proxy
+	auto const& proxy = GetProxyOnGameThread<FRWA_HeliAnimInstanceProxy>();
+	TArray<FRWA_RotorAnimData> const& rotors = proxy.GetAnimData();
+	if (m_AppliedRotorBlur.Num() != rotors.Num())
+		m_AppliedRotorBlur.Init(false, rotors.Num());
+
+	// Material parameters are only touched when a rotor crosses its threshold
+	for (int32 i = 0; i < rotors.Num(); ++i) {
+		FRWA_RotorAnimData const& rotor = rotors[i];
+		if (rotor.IsBlurred == m_AppliedRotorBlur[i])
+			continue;
+
+		m_AppliedRotorBlur[i] = rotor.IsBlurred;
+
+		if (rotor.BlurParameter != EName::None)
+			mesh->SetScalarParameterValueOnMaterials(rotor.BlurParameter, rotor.IsBlurred ? 1.f : 0.f);
+	}
+}
+
+
+// Rotor LOD -------------------------------------------------------------------
+
+void URWA_HeliAnimInstance::RegisterSignificance()
+{
+	if (m_IsSignificanceRegistered)
+		return;
+
+	USignificanceManager* sm = USignificanceManager::Get(GetWorld());
+	USkeletalMeshComponent* mesh = GetSkelMeshComponent();
+	if (!sm || !mesh)
+		return;
+
+	// The significance function is evaluated in parallel, so it only reads the
+	// mesh's bounds and render state. The LOD is applied afterwards, sequentially
+	// on the game thread.
+	sm->RegisterObject(
+		this,
+		k_SignificanceTag,
+		[](USignificanceManager::FManagedObjectInfo* info, FTransform const& viewpoint) -> float
+		{
+			return CastChecked<URWA_HeliAnimInstance>(info->GetObject())->CalculateSignificance(viewpoint);
+		},
+		USignificanceManager::EPostSignificanceType::Sequential,
+		[](USignificanceManager::FManagedObjectInfo* info, float, float significance, bool)
+		{
+			CastChecked<URWA_HeliAnimInstance>(info->GetObject())->ApplyRotorLOD(significance);
+		});
+
+	// Let the significance manager drive the mesh's update rate, so skipped
+	// frames don't evaluate any bones. Interpolating between skipped frames
+	// would blend rotor poses that can be more than half a revolution apart, so
+	// the rotors just hold their last pose instead. Update rate optimizations
+	// already spread meshes across frames. Without them, the rest of the mesh's
+	// animation is left alone, and only the rotor angles are throttled.
+	if (mesh->bEnableUpdateRateOptimizations || ThrottleMeshAnimation) {
+		m_OriginalTickRateState = FExternalTickRateState {
+			mesh->bEnableUpdateRateOptimizations,
+			mesh->IsUsingExternalTickRateControl(),
+			mesh->IsUsingExternalInterpolation(),
+			mesh->GetExternalTickRate(),
+		};
+
+		mesh->bEnableUpdateRateOptimizations = true;
+		mesh->EnableExternalTickRateControl(true);
+		mesh->EnableExternalInterpolation(false);
+		mesh->SetExternalTickRate(1);
+	}
+
+	m_RotorUpdateInterval = 1;
+	m_RotorUpdatePhase = s_NextRotorUpdatePhase++;
+
+	if (SkipEvaluationWhenNotRendered) {
+		m_OriginalTickOption = mesh->VisibilityBasedAnimTickOption;
+		mesh->VisibilityBasedAnimTickOption = EVisibilityBasedAnimTickOption::OnlyTickMontagesWhenNotRendered;
+	}
+
+	m_IsSignificanceRegistered = true;
+}
+
+void URWA_HeliAnimInstance::UnregisterSignificance()
+{
+	if (!m_IsSignificanceRegistered)
+		return;
+
+	if (USignificanceManager* sm = USignificanceManager::Get(GetWorld()))
+		sm->UnregisterObject(this);
+
+	if (USkeletalMeshComponent* mesh = GetSkelMeshComponent()) {
+		if (m_OriginalTickRateState.IsSet()) {
+			FExternalTickRateState const& state = m_OriginalTickRateState.GetValue();
+			mesh->bEnableUpdateRateOptimizations = state.UpdateRateOptimizations;
+			mesh->EnableExternalTickRateControl(state.TickRateControlled);
+			mesh->EnableExternalInterpolation(state.Interpolate);
+			mesh->SetExternalTickRate(state.TickRate);
+		}
+
+		if (m_OriginalTickOption.IsSet())
+			mesh->VisibilityBasedAnimTickOption = m_OriginalTickOption.GetValue();
+	}
+
+	m_OriginalTickOption.Reset();
+	m_OriginalTickRateState.Reset();
+	m_RotorUpdateInterval = 1;
+	m_IsSignificanceRegistered = false;
+}
+
+float URWA_HeliAnimInstance::CalculateSignificance(FTransform const& viewpoint) const
+{
+	USkeletalMeshComponent const* mesh = GetSkelMeshComponent();
+	if (!mesh || !mesh->WasRecentlyRendered(0.2f))
+		return 0;
+
+	FBoxSphereBounds const& bounds = mesh->Bounds;
+	float dist = FVector::Dist(viewpoint.GetLocation(), bounds.Origin);
+
+	return bounds.SphereRadius / FMath::Max(dist, 1.f);
+}
+
+void URWA_HeliAnimInstance::ApplyRotorLOD(float significance)
+{
+	USkeletalMeshComponent* mesh = GetSkelMeshComponent();
+	if (!mesh)
+		return;
+
+	int32 lod = 0;
+	for (float threshold : RotorLODScreenSizes)
+		if (significance < threshold)
+			++lod;
+
+	int32 const interval = 1 << FMath::Min(lod, 7);
+
+	if (m_OriginalTickRateState.IsSet())
+		mesh->SetExternalTickRate(static_cast<uint8>(interval));
+	else
+		m_RotorUpdateInterval = interval;
+}
+
+FAnimInstanceProxy* URWA_HeliAnimInstance::CreateAnimInstanceProxy() 
+{
+	// Owned and destroyed by UAnimInstance
+	return new FRWA_HeliAnimInstanceProxy(this);
+}
@@ -23,8 +23,14 @@ void URWA_HeliMovementComponent::TickComponent(float deltaTime, ELevelTick type,
 {
 	Super::TickComponent(deltaTime, type, fn);
 
-	if (FBodyInstance* body = GetBodyInstance())
+	if (FBodyInstance* body = GetBodyInstance()) {
+		// Snapshot this frame's input for the substeps that will simulate it.
+		// Custom physics runs on the game thread during the physics pre-tick, so
+		// there's nothing to synchronize.
+		m_Input = m_GameInput;
+
 		body->AddCustomPhysics(OnCalculateCustomPhysics);
+	}
 	else {
 		HELI_WARN("Failed to get body instance!");
 	}
@@ -415,17 +421,17 @@ float URWA_HeliMovementComponent::GetCurrentRPM() const
 
 float URWA_HeliMovementComponent::GetCurrentCollective() const
 {
-	return m_Input.Collective;
+	return m_GameInput.Collective;
 }
 
 FVector2D URWA_HeliMovementComponent::GetCurrentCyclic() const 
 {
-	return { m_Input.Roll, m_Input.Pitch };
+	return { m_GameInput.Roll, m_GameInput.Pitch };
 }
 
 float URWA_HeliMovementComponent::GetCurrentTorque() const
 {
-	return m_Input.Yaw;
+	return m_GameInput.Yaw;
 }
 
 FVector URWA_HeliMovementComponent::GetVelocity() const 
@@ -453,10 +459,7 @@ float URWA_HeliMovementComponent::GetVerticalAirspeed() const
 
 float URWA_HeliMovementComponent::GetHeadingDegrees() const
 {
-	FVector direction = FVector::VectorPlaneProject(Forward(), FVector::UpVector);
-	direction.Normalize();
-
-	return FMath::RadiansToDegrees(FMath::Atan2(-direction.Y, -direction.X)) + 180.0;
+	return HeadingForDirection(Forward());
 }
 
 float URWA_HeliMovementComponent::GetRadarAltitude() const
@@ -477,6 +480,68 @@ float URWA_HeliMovementComponent::GetRadarAltitude() const
 	return INFINITY;
 }
 
+FRWA_FlightInstruments URWA_HeliMovementComponent::GetFlightInstruments() const
+{
+	if (m_InstrumentsFrame != GFrameCounter)
+	{
+		UpdateFlightInstruments(m_Instruments);
+		m_InstrumentsFrame = GFrameCounter;
+	}
+
+	return m_Instruments;
+}
+
+
+// Flight Instruments ----------------------------------------------------------
+
+void URWA_HeliMovementComponent::UpdateFlightInstruments(FRWA_FlightInstruments& out_instruments) const
+{
+	FVector lv = m_PhysicsState.LinearVelocity;
+	float airspeed = FVector { lv.X, lv.Y, 0 }.Size();
+
+	out_instruments.Airspeed = airspeed;
+	out_instruments.AirspeedKnots = airspeed * k_CmPerSecToKnots;
+	out_instruments.VerticalSpeed = lv.Z;
+	out_instruments.RadarAltitude = GetRadarAltitude();
+	out_instruments.RPM = m_EngineState.RPM;
+	out_instruments.Collective = m_GameInput.Collective;
+	out_instruments.Cyclic = { m_GameInput.Roll, m_GameInput.Pitch };
+	out_instruments.AntiTorque = m_GameInput.Yaw;
+
+	APawn* pawn = GetPawn();
+	if (pawn == nullptr)
+	{
+		out_instruments.Heading = 0;
+		out_instruments.Pitch = 0;
+		out_instruments.Bank = 0;
+		out_instruments.GLoad = 1;
+		return;
+	}
+
+	FTransform const& xform = pawn->GetActorTransform();
+	FQuat rotation = xform.GetRotation();
+	FRotator rotator = rotation.Rotator();
+
+	out_instruments.Heading = HeadingForDirection(rotation.GetForwardVector());
+	out_instruments.Pitch = rotator.Pitch;
+	out_instruments.Bank = rotator.Roll;
+
+	// GForce is the local-space acceleration in units of gravity, so the load
+	// factor is what's left after taking out the acceleration due to gravity
+	FVector accel = m_PhysicsState.GForce * k_Gravity;
+	FVector gravity = xform.InverseTransformVectorNoScale({ 0, 0, k_Gravity });
+
+	out_instruments.GLoad = (accel - gravity).Z / -k_Gravity;
+}
+
+float URWA_HeliMovementComponent::HeadingForDirection(FVector const& forward)
+{
+	FVector direction = FVector::VectorPlaneProject(forward, FVector::UpVector);
+	direction.Normalize();
+
+	return FMath::RadiansToDegrees(FMath::Atan2(-direction.Y, -direction.X)) + 180.0;
+}
+
 
 // Blueprint Methods -----------------------------------------------------------
 
@@ -497,22 +562,48 @@ void URWA_HeliMovementComponent::SetCollectiveInput(float value)
 	if (value > 0 && m_EngineState.Phase == EEngineState::Off)
 		StartEngine();
 
-	m_Input.Collective = value;
+	m_GameInput.Collective = value;
 }
 
 void URWA_HeliMovementComponent::SetPitchInput(float value)
 {
-	m_Input.Pitch = value;
+	m_GameInput.Pitch = value;
 }
 
 void URWA_HeliMovementComponent::SetRollInput(float value)
 {
-	m_Input.Roll = value;
+	m_GameInput.Roll = value;
 }
 
 void URWA_HeliMovementComponent::SetYawInput(float value)
 {
-	m_Input.Yaw = value;
+	m_GameInput.Yaw = value;
+}
+
+void URWA_HeliMovementComponent::ApplyControlFrame(FRWA_ControlFrame const& frame)
+{
+	switch (frame.Engine) {
+		case ERWA_EngineCommand::Start: StartEngine(); break;
+		case ERWA_EngineCommand::Stop: StopEngine(); break;
+		default: break;
+	}
+
+	SetCollectiveInput(frame.Collective);
+
+	m_GameInput.Pitch = frame.Pitch;
+	m_GameInput.Roll = frame.Roll;
+	m_GameInput.Yaw = frame.Yaw;
+}
+
+void URWA_HeliMovementComponent::ApplyControlFrames(
+	TArrayView<Self* const> components,
+	TArrayView<FRWA_ControlFrame const> frames)
+{
+	check(components.Num() == frames.Num());
+
+	for (int32 i = 0; i < components.Num(); ++i)
+		if (Self* cmp = components[i])
+			cmp->ApplyControlFrame(frames[i]);
 }
 
 
@@ -73,7 +73,10 @@ void UInputModifier_RWA_VirtualJoystick::SetupCurves()
 	setupCurve(m_CurveIn, Resistance, Attack, SpringTension, SpringBalance);
 	setupCurve(m_CurveOut, Resistance, SpringTension, Damping, 1.f - SpringBalance);
 
-	m_ActiveCurve = &m_CurveIn;
+	m_SolverIn = FCubicBezierSolver(m_CurveIn);
+	m_SolverOut = FCubicBezierSolver(m_CurveOut);
+
+	m_ActiveCurve = &m_SolverIn;
 	m_NeedsInit = false;
 }
 
@@ -92,7 +95,7 @@ FInputActionValue UInputModifier_RWA_VirtualJoystick::ModifyRaw(float value, flo
 		}
 		else {
 			m_PrevCurve = m_ActiveCurve;
-			m_ActiveCurve = m_Phase == Falling ? &m_CurveOut : &m_CurveIn;
+			m_ActiveCurve = m_Phase == Falling ? &m_SolverOut : &m_SolverIn;
 		}
 	}
 
@@ -120,28 +123,147 @@ FInputActionValue UInputModifier_RWA_VirtualJoystick::ModifyRaw(float value, flo
 	return FInputActionValue(result);
 }
 
-FInputActionValue UInputModifier_RWA_VirtualJoystick::ModifyRaw(
-	FVector2D value,
-	float deltaTime)
-	const 
+FInputActionValue UInputModifier_RWA_VirtualJoystick::ModifyRaw(FVector2D value, float deltaTime)
 {
-	if (value.IsNearlyZero())
-		return FInputActionValue(value);
+	FVector result = ModifyAxes({ value.X, value.Y, 0 }, 2, deltaTime);
+	return FInputActionValue(FVector2D(result.X, result.Y));
+}
 
-	FVector2D prev = m_PrevInput.Get<FVector2D>();
-	FVector2D result = FMath::Vector2DInterpTo(prev, value, deltaTime, SpringTension);
-	return FInputActionValue(result);
+FInputActionValue UInputModifier_RWA_VirtualJoystick::ModifyRaw(FVector value, float deltaTime)
+{
+	return FInputActionValue(ModifyAxes(value, 3, deltaTime));
 }
 
-FInputActionValue UInputModifier_RWA_VirtualJoystick::ModifyRaw(
-	FVector value,
+FVector UInputModifier_RWA_VirtualJoystick::ModifyAxes(
+	FVector const& value,
+	int32 numAxes,
 	float deltaTime)
-	const 
 {
-	if (value.IsNearlyZero())
-		return FInputActionValue(value);
+	check(numAxes <= k_MaxAxes);
 
-	FVector prev = m_PrevInput.Get<FVector>();
-	FVector result = FMath::VInterpTo(prev, value, deltaTime, SpringTension);
-	return FInputActionValue(result);
+	// Start a new curve for any axis whose target changed this tick
+	for (int32 i = 0; i < numAxes; ++i) {
+		float target = static_cast<float>(value[i]);
+		float change = FMath::Abs(target - m_AxisTargets[i]);
+
+		// Small changes at rest are passed straight through (see below)
+		if (change == 0 || (m_AxisPhases[i] == None && change <= 0.5f))
+			continue;
+
+		float sign = FMath::Sign(target);
+		float current = m_AxisMagnitudes[i];
+		bool reversed = sign == -m_AxisSigns[i];
+
+		// When the input has reversed, head for rest first. The axis then rises
+		// on the other side once it gets there (see below), so it eases through
+		// zero instead of jumping to it.
+		float goal = reversed ? 0.f : FMath::Abs(target);
+
+		if (RetargetAxis(i, goal)) {
+			// Already heading that way, so carry on without a kink
+		}
+		else if (goal == 0) {
+			// Ease back to rest from the current output
+			StartFalling(i);
+		}
+		else {
+			// Ease from the current output to the new magnitude, over the
+			// fraction of the curve's duration that it has left to cover
+			m_AxisSigns[i] = sign;
+			StartEasing(i, goal > current ? Rising : Falling, current, goal);
+		}
+	}
+
+	// Advance every axis along its curve at once
+	VectorRegister4Float duration = VectorLoadAligned(m_AxisDurations);
+	VectorRegister4Float speed = VectorMultiply(VectorLoadAligned(m_AxisSpeeds), VectorSetFloat1(deltaTime));
+	VectorRegister4Float x = VectorAdd(VectorLoadAligned(m_AxisX), speed);
+	x = VectorMin(x, duration);
+	VectorStoreAligned(x, m_AxisX);
+	VectorStoreAligned(m_AxisCurves.YForX(x), m_AxisY);
+
+	FVector result = value;
+
+	for (int32 i = 0; i < numAxes; ++i) {
+		float target = static_cast<float>(value[i]);
+		bool finished = m_AxisX[i] >= m_AxisDurations[i];
+		m_AxisTargets[i] = target;
+
+		switch (m_AxisPhases[i]) {
+			case None:
+				m_AxisMagnitudes[i] = FMath::Abs(target);
+				if (!FMath::IsNearlyZero(target))
+					m_AxisSigns[i] = FMath::Sign(target);
+				break;
+
+			case Rising:
+			case Falling:
+				m_AxisMagnitudes[i] = m_AxisOrigins[i] + m_AxisScales[i] * (finished ? 1.f : m_AxisY[i]);
+				result[i] = m_AxisSigns[i] * m_AxisMagnitudes[i];
+
+				// Back at rest after a reversal -- carry on to the other side
+				if (finished
+					&& !FMath::IsNearlyZero(target)
+					&& FMath::Sign(target) != m_AxisSigns[i])
+				{
+					m_AxisSigns[i] = FMath::Sign(target);
+					StartEasing(i, Rising, 0.f, FMath::Abs(target));
+					continue;
+				}
+				break;
+		}
+
+		if (finished)
+			m_AxisPhases[i] = None;
+	}
+
+	return result;
+}
+
+void UInputModifier_RWA_VirtualJoystick::StartEasing(int32 axis, EPhase phase, float from, float to)
+{
+	FCubicBezierSolver const& solver = phase == Rising ? m_SolverIn : m_SolverOut;
+
+	m_AxisPhases[axis] = phase;
+	m_AxisCurves.SetCurve(axis, solver);
+	m_AxisDurations[axis] = solver.Duration();
+	m_AxisX[axis] = 0;
+	m_AxisOrigins[axis] = from;
+	m_AxisScales[axis] = to - from;
+
+	// The whole curve spans the full range in one go, so a shorter distance
+	// takes proportionally less time
+	m_AxisSpeeds[axis] = solver.Duration() / FMath::Max(FMath::Abs(to - from), UE_KINDA_SMALL_NUMBER);
+}
+
+void UInputModifier_RWA_VirtualJoystick::StartFalling(int32 axis)
+{
+	m_AxisPhases[axis] = Falling;
+	m_AxisCurves.SetCurve(axis, m_SolverOut);
+	m_AxisDurations[axis] = m_SolverOut.Duration();
+	m_AxisSpeeds[axis] = m_SolverOut.Duration();
+	m_AxisX[axis] = m_SolverOut.XForY(1.f - m_AxisMagnitudes[axis]);
+	m_AxisOrigins[axis] = 1.f;
+	m_AxisScales[axis] = -1.f;
+}
+
+bool UInputModifier_RWA_VirtualJoystick::RetargetAxis(int32 axis, float magnitude)
+{
+	if (m_AxisPhases[axis] == None)
+		return false;
+
+	// Only an axis that's already heading toward the new magnitude can carry on
+	float remaining = magnitude - m_AxisMagnitudes[axis];
+	float progress = m_AxisY[axis];
+	if (remaining * m_AxisScales[axis] <= 0 || progress >= 1.f - UE_KINDA_SMALL_NUMBER)
+		return false;
+
+	// Stretch what's left of the curve to end at the new magnitude, and slow
+	// it down by as much, so both the output and its rate carry on unchanged
+	float scale = remaining / (1.f - progress);
+	m_AxisSpeeds[axis] *= m_AxisScales[axis] / scale;
+	m_AxisOrigins[axis] = magnitude - scale;
+	m_AxisScales[axis] = scale;
+
+	return true;
 }
@@ -1,7 +1,9 @@
 ﻿#include "RWA/Input/InputModifier_VirtualThrottle.h"
 
+#include "EnhancedPlayerInput.h"
 
-TMap<FName,FInputActionValue> UInputModifier_RWA_VirtualThrottle::s_AxisValues {};
+
+TSparseArray<UInputModifier_RWA_VirtualThrottle::FPlayerAxes> UInputModifier_RWA_VirtualThrottle::s_Players {};
 
 FInputActionValue UInputModifier_RWA_VirtualThrottle::ModifyRaw_Implementation(
 	UEnhancedPlayerInput const* input,
@@ -14,7 +16,7 @@ FInputActionValue UInputModifier_RWA_VirtualThrottle::ModifyRaw_Implementation(
 		return 0;
 	}
 
-	FInputActionValue& current = s_AxisValues.FindOrAdd(AxisID, {});
+	FInputActionValue& current = GetAxisValue(input);
 
 	if (value.IsNonZero())
 	{
@@ -44,3 +46,59 @@ FInputActionValue UInputModifier_RWA_VirtualThrottle::ModifyRaw_Implementation(
 
 	return current;
 }
+
+FInputActionValue& UInputModifier_RWA_VirtualThrottle::GetAxisValue(UEnhancedPlayerInput const* input)
+{
+	// Handles are only invalidated when the player input changes (e.g. this
+	// modifier is shared between players) or its slot is recycled. A recycled
+	// slot may even belong to the same input again, with its axes registered in
+	// a different order, so the axis handle is checked against its ID as well.
+	if (m_PlayerHandle == INDEX_NONE
+		|| m_ResolvedAxisID != AxisID
+		|| !s_Players.IsValidIndex(m_PlayerHandle)
+		|| !IsAxisHandleValid(s_Players[m_PlayerHandle], input))
+	{
+		ResolveHandles(input);
+	}
+
+	return s_Players[m_PlayerHandle].Values[m_AxisHandle];
+}
+
+bool UInputModifier_RWA_VirtualThrottle::IsAxisHandleValid(
+	FPlayerAxes const& player,
+	UEnhancedPlayerInput const* input)
+	const
+{
+	return player.Input.Get() == input
+		&& player.AxisIDs.IsValidIndex(m_AxisHandle)
+		&& player.Values.IsValidIndex(m_AxisHandle)
+		&& player.AxisIDs[m_AxisHandle] == AxisID;
+}
+
+void UInputModifier_RWA_VirtualThrottle::ResolveHandles(UEnhancedPlayerInput const* input)
+{
+	m_PlayerHandle = INDEX_NONE;
+
+	for (auto it = s_Players.CreateIterator(); it; ++it) {
+		if (it->Input.Get() == input) {
+			m_PlayerHandle = it.GetIndex();
+		}
+		// Release the storage of players that have since been destroyed
+		else if (it->Input.IsStale()) {
+			it.RemoveCurrent();
+		}
+	}
+
+	if (m_PlayerHandle == INDEX_NONE)
+		m_PlayerHandle = s_Players.Add({ input });
+
+	FPlayerAxes& player = s_Players[m_PlayerHandle];
+
+	m_AxisHandle = player.AxisIDs.Find(AxisID);
+	if (m_AxisHandle == INDEX_NONE) {
+		m_AxisHandle = player.AxisIDs.Add(AxisID);
+		player.Values.Emplace();
+	}
+
+	m_ResolvedAxisID = AxisID;
+}
@@ -0,0 +1,274 @@
+﻿#include "CoreMinimal.h"
+#include "Misc/AutomationTest.h"
+#include "RWA/Input/CubicBezier.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+// Test curves -----------------------------------------------------------------
+
+struct FRWA_CubicBezierPreset
+{
+	TCHAR const* Name;
+	FCubicBezier Curve;
+};
+
+/** The CSS easing presets, and the curves the Virtual Joystick builds from its settings */
+static TArray<FRWA_CubicBezierPreset> const& GetCubicBezierPresets()
+{
+	static TArray<FRWA_CubicBezierPreset> const s_presets {
+		{ TEXT("Linear"),      { { 0, 0 }, { 0, 0 },       { 1, 1 },            { 1, 1 } } },
+		{ TEXT("Ease"),        { { 0, 0 }, { 0.25f, 0.1f }, { 0.25f, 1 },        { 1, 1 } } },
+		{ TEXT("EaseIn"),      { { 0, 0 }, { 0.42f, 0 },   { 1, 1 },            { 1, 1 } } },
+		{ TEXT("EaseOut"),     { { 0, 0 }, { 0, 0 },       { 0.58f, 1 },        { 1, 1 } } },
+		{ TEXT("EaseInOut"),   { { 0, 0 }, { 0.42f, 0 },   { 0.58f, 1 },        { 1, 1 } } },
+		// Default settings
+		{ TEXT("Joystick"),      { { 0, 0 }, { 0, 0 },       { 0.34375f, 0.8125f }, { 1, 1 } } },
+		// Attack 0.9, Spring Tension 1, Spring Balance 1
+		{ TEXT("JoystickStiff"), { { 0, 0 }, { 0, 0 },       { 0.1f, 1 },         { 1.1f, 1 } } },
+		// Resistance 5
+		{ TEXT("JoystickSlow"),  { { 0, 0 }, { 0, 0 },       { 2.5f, 0.5f },      { 5, 1 } } },
+	};
+
+	return s_presets;
+}
+
+/**
+ * Invert the curve along one axis in double precision, with enough bisection
+ * steps to exhaust it, and return the value on the other axis.
+ */
+static double SolveReference(FCubicBezier const& curve, double value, bool solveForX)
+{
+	auto get = [&curve](double t) -> FVector2D
+	{
+		double const mt = 1.0 - t;
+
+		return FVector2D(curve.P0) * (mt * mt * mt)
+			+ FVector2D(curve.P1) * (3.0 * mt * mt * t)
+			+ FVector2D(curve.P2) * (3.0 * mt * t * t)
+			+ FVector2D(curve.P3) * (t * t * t);
+	};
+
+	double lower = 0;
+	double upper = 1;
+
+	for (int32 i = 0; i < 64; ++i) {
+		double const t = (lower + upper) * 0.5;
+		FVector2D const point = get(t);
+
+		if ((solveForX ? point.X : point.Y) < value)
+			lower = t;
+		else
+			upper = t;
+	}
+
+	FVector2D const point = get((lower + upper) * 0.5);
+
+	return solveForX ? point.Y : point.X;
+}
+
+
+// Accuracy --------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FRWA_CubicBezierSolverAccuracyTest,
+	"RotaryWingAircraft.Input.CubicBezier.SolverAccuracy",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRWA_CubicBezierSolverAccuracyTest::RunTest(FString const&)
+{
+	constexpr float tolerance = FCubicBezierSolver::k_Tolerance;
+	constexpr int32 numSamples = 1000;
+
+	for (FRWA_CubicBezierPreset const& preset : GetCubicBezierPresets()) {
+		FCubicBezier const& curve = preset.Curve;
+		FCubicBezierSolver const solver (curve);
+
+		TestNearlyEqual(
+			*FString::Printf(TEXT("%s: Duration"), preset.Name),
+			solver.Duration(),
+			curve.Duration(),
+			UE_KINDA_SMALL_NUMBER);
+
+		double maxSolverError = 0;
+		double maxBisectionError = 0;
+
+		for (int32 i = 0; i <= numSamples; ++i) {
+			// Sweep [0,1] along the curve's duration for YForX, and directly for XForY
+			float const alpha = static_cast<float>(i) / numSamples;
+			float const x = curve.P0.X + curve.Duration() * alpha;
+			float const y = alpha;
+
+			// The solver's guarantee is on the solved axis: the `t` it finds lands
+			// within k_Tolerance of the input. Get can round a few ULPs differently
+			// from the solver's own residual, so that much is allowed on top.
+			struct FCase { TCHAR const* Func; float Input; float Residual; };
+			FCase const cases[] {
+				{ TEXT("TForX"), x, solver.Get(solver.TForX(x)).X - x },
+				{ TEXT("TForY"), y, solver.Get(solver.TForY(y)).Y - y },
+			};
+
+			for (FCase const& test : cases) {
+				float const bound = tolerance + 4.f * FLT_EPSILON * FMath::Max(1.f, FMath::Abs(test.Input));
+				if (FMath::Abs(test.Residual) > bound) {
+					AddError(FString::Printf(
+						TEXT("%s: %s(%f) is off by %g on the solved axis (tolerance %g)"),
+						preset.Name, test.Func, test.Input, test.Residual, tolerance));
+				}
+			}
+
+			// On the other axis, that's magnified by the curve's slope. Only
+			// reported, for comparison with the bisection search.
+			double const referenceY = SolveReference(curve, x, true);
+			double const referenceX = SolveReference(curve, y, false);
+			maxSolverError = FMath::Max3(
+				maxSolverError,
+				FMath::Abs(solver.YForX(x) - referenceY),
+				FMath::Abs(solver.XForY(y) - referenceX));
+			maxBisectionError = FMath::Max3(
+				maxBisectionError,
+				FMath::Abs(curve.YForX(x) - referenceY),
+				FMath::Abs(curve.XForY(y) - referenceX));
+		}
+
+		AddInfo(FString::Printf(
+			TEXT("%s: max error %.2e (bisection search %.2e)"),
+			preset.Name, maxSolverError, maxBisectionError));
+	}
+
+	return !HasAnyErrors();
+}
+
+
+// Batch -----------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FRWA_CubicBezierBatchTest,
+	"RotaryWingAircraft.Input.CubicBezier.BatchMatchesSolver",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FRWA_CubicBezierBatchTest::RunTest(FString const&)
+{
+	// Both solve to k_Tolerance on the solved axis, but from different initial
+	// guesses, so their results can differ by that much times the curve's slope
+	constexpr float tolerance = 2.5e-4f;
+	constexpr int32 numSamples = 1000;
+	constexpr int32 width = FCubicBezierBatch::k_Width;
+
+	TArray<FRWA_CubicBezierPreset> const& presets = GetCubicBezierPresets();
+
+	// Each lane gets a different curve, four presets at a time
+	for (int32 first = 0; first < presets.Num(); first += width) {
+		FCubicBezierBatch batch;
+		FCubicBezierSolver solvers[width];
+		FCubicBezier curves[width];
+
+		for (int32 lane = 0; lane < width; ++lane) {
+			curves[lane] = presets[(first + lane) % presets.Num()].Curve;
+			solvers[lane] = FCubicBezierSolver(curves[lane]);
+			batch.SetCurve(lane, curves[lane]);
+		}
+
+		// Overshoot both ends, to check that the batch clamps to the curve's range
+		for (int32 i = -numSamples / 4; i <= numSamples + numSamples / 4; ++i) {
+			alignas(16) float x[width];
+			alignas(16) float y[width];
+
+			for (int32 lane = 0; lane < width; ++lane) {
+				float const alpha = static_cast<float>(i + lane) / numSamples;
+				x[lane] = curves[lane].P0.X + curves[lane].Duration() * alpha;
+				y[lane] = alpha;
+			}
+
+			alignas(16) float batchY[width];
+			alignas(16) float batchX[width];
+			batch.YForX(x, batchY);
+			batch.XForY(y, batchX);
+
+			for (int32 lane = 0; lane < width; ++lane) {
+				TCHAR const* name = presets[(first + lane) % presets.Num()].Name;
+				float const solvedY = solvers[lane].YForX(x[lane]);
+				float const solvedX = solvers[lane].XForY(y[lane]);
+
+				if (FMath::Abs(batchY[lane] - solvedY) > tolerance) {
+					AddError(FString::Printf(
+						TEXT("%s (lane %d): YForX(%f) = %f, but the solver gives %f"),
+						name, lane, x[lane], batchY[lane], solvedY));
+				}
+				if (FMath::Abs(batchX[lane] - solvedX) > tolerance) {
+					AddError(FString::Printf(
+						TEXT("%s (lane %d): XForY(%f) = %f, but the solver gives %f"),
+						name, lane, y[lane], batchX[lane], solvedX));
+				}
+			}
+		}
+	}
+
+	return !HasAnyErrors();
+}
+
+
+// Benchmark -------------------------------------------------------------------
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FRWA_CubicBezierSolverBenchmark,
+	"RotaryWingAircraft.Input.CubicBezier.SolverBenchmark",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::PerfFilter)
+
+bool FRWA_CubicBezierSolverBenchmark::RunTest(FString const&)
+{
+	constexpr int32 numSamples = 1000;
+	constexpr int32 numPasses = 100;
+
+	// Summed and reported, so the calls can't be optimized away
+	float checksum = 0;
+
+	auto time = [&](auto&& yForX, auto&& xForY) -> double
+	{
+		double const start = FPlatformTime::Seconds();
+
+		for (int32 pass = 0; pass < numPasses; ++pass) {
+			for (int32 i = 0; i <= numSamples; ++i) {
+				float const alpha = static_cast<float>(i) / numSamples;
+				checksum += yForX(alpha) + xForY(alpha);
+			}
+		}
+
+		return FPlatformTime::Seconds() - start;
+	};
+
+	double totalBisection = 0;
+	double totalSolver = 0;
+	double const callsPerCurve = 2.0 * numPasses * (numSamples + 1);
+
+	for (FRWA_CubicBezierPreset const& preset : GetCubicBezierPresets()) {
+		FCubicBezier const& curve = preset.Curve;
+		FCubicBezierSolver const solver (curve);
+		float const duration = curve.Duration();
+
+		double const bisection = time(
+			[&](float alpha) { return curve.YForX(curve.P0.X + duration * alpha); },
+			[&](float alpha) { return curve.XForY(alpha); });
+
+		double const solved = time(
+			[&](float alpha) { return solver.YForX(curve.P0.X + duration * alpha); },
+			[&](float alpha) { return solver.XForY(alpha); });
+
+		AddInfo(FString::Printf(
+			TEXT("%s: bisection %.1f ns/call, solver %.1f ns/call (%.1fx)"),
+			preset.Name,
+			bisection / callsPerCurve * 1e9,
+			solved / callsPerCurve * 1e9,
+			bisection / FMath::Max(solved, UE_DOUBLE_SMALL_NUMBER)));
+
+		totalBisection += bisection;
+		totalSolver += solved;
+	}
+
+	double const speedup = totalBisection / FMath::Max(totalSolver, UE_DOUBLE_SMALL_NUMBER);
+	AddInfo(FString::Printf(TEXT("Overall speedup: %.1fx (checksum %f)"), speedup, checksum));
+
+	return !HasAnyErrors();
+}
+
+#endif
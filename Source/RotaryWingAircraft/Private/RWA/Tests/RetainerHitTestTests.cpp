@@ -0,0 +1,74 @@
+﻿#include "CoreMinimal.h"
+#include "Framework/Application/SlateApplication.h"
+#include "HAL/IConsoleManager.h"
+#include "Input/HittestGrid.h"
+#include "Misc/App.h"
+#include "Misc/AutomationTest.h"
+#include "RWA/HUD/SRetainerWidget.h"
+#include "Widgets/Input/SButton.h"
+#include "Widgets/SWindow.h"
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(
+	FRWA_RetainerHitTestTest,
+	"RotaryWingAircraft.HUD.Retainer.NotHitTestable",
+	EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+/**
+ * A retainer that isn't hit-testable must never merge its nested grid into
+ * the root grid, so the content can't be found there no matter how many
+ * times it's painted.
+ */
+bool FRWA_RetainerHitTestTest::RunTest(FString const& parameters)
+{
+	if (!FSlateApplication::IsInitialized()) {
+		AddInfo(TEXT("Slate isn't initialized, skipping"));
+		return true;
+	}
+
+	IConsoleVariable const* retainedRendering = IConsoleManager::Get()
+		.FindConsoleVariable(TEXT("Slate.RWAEnableRetainedRendering"));
+	if (!retainedRendering || retainedRendering->GetInt() == 0) {
+		AddInfo(TEXT("Retained rendering is disabled, skipping"));
+		return true;
+	}
+
+	FVector2f const size { 200, 100 };
+
+	TSharedRef<SButton> button = SNew(SButton);
+	TSharedRef<SRWA_RetainerWidget> retainer = SNew(SRWA_RetainerWidget)
+		.HitTestable(false)
+		.RenderOnPhase(false)
+		[
+			button
+		];
+
+	TSharedRef<SWindow> window = SNew(SWindow)
+		.ClientSize(FVector2D(size));
+
+	FGeometry const geo = FGeometry::MakeRoot(FVector2D(size), FSlateLayoutTransform());
+	FSlateRect const cullingRect { FVector2f::ZeroVector, size };
+
+	for (int32 frame = 0; frame < 3; ++frame) {
+		FHittestGrid rootGrid;
+		rootGrid.SetHittestArea(FVector2f::ZeroVector, size);
+
+		FSlateWindowElementList elements (window);
+		FPaintArgs args (nullptr, rootGrid, FVector2f::ZeroVector, FApp::GetCurrentTime(), 0.f);
+
+		retainer->SlatePrepass(1.f);
+		retainer->Paint(args, geo, cullingRect, elements, 0, FWidgetStyle(), true);
+
+		bool found = false;
+		for (FWidgetAndPointer const& entry : rootGrid.GetBubblePath(size / 2, 0.f, true))
+			found |= entry.Widget == button;
+
+		TestFalse(TEXT("Content of a non-hit-testable retainer is in the root grid"), found);
+	}
+
+	return !HasAnyErrors();
+}
+
+#endif
@@ -1,3 +1,100 @@
 ﻿#include "RotaryWingAircraft.h"
 
+#include "Algo/Compare.h"
+#include "SignificanceManager.h"
+#include "UObject/ObjectKey.h"
+
+
+static int32 g_UpdateSignificanceManager = -1;
+static FAutoConsoleVariableRef RWA_UpdateSignificanceManager {
+	TEXT("RWA.UpdateSignificanceManager"),
+	g_UpdateSignificanceManager,
+	TEXT("Whether to update the Significance Manager with the local players' "
+		"viewpoints every frame, which the rotor LOD needs. -1 (default): only "
+		"while nothing else updates it. 1: always. 0: never."),
+};
+
+// The viewpoints last given to each world's Significance Manager. In auto mode,
+// finding anything else there means the game is updating it itself.
+static TMap<TObjectKey<UWorld>, TArray<FTransform>> s_LastViewpoints;
+static TSet<TObjectKey<UWorld>> s_WorldsUpdatedByGame;
+
+static bool IsUpdatedByGame(UWorld* world, USignificanceManager const* sm)
+{
+	if (s_WorldsUpdatedByGame.Contains(world))
+		return true;
+
+	TArray<FTransform> const& current = sm->GetViewpoints();
+	TArray<FTransform> const* ours = s_LastViewpoints.Find(world);
+
+	bool const isOurs = ours
+		? Algo::Compare(*ours, current, [](FTransform const& a, FTransform const& b) -> bool {
+			return a.Equals(b);
+		})
+		: current.IsEmpty();
+
+	if (isOurs)
+		return false;
+
+	s_WorldsUpdatedByGame.Add(world);
+	s_LastViewpoints.Remove(world);
+
+	return true;
+}
+
+static void UpdateSignificanceManager(UWorld* world, ELevelTick, float)
+{
+	if (!g_UpdateSignificanceManager || !world || !world->IsGameWorld())
+		return;
+
+	USignificanceManager* sm = USignificanceManager::Get(world);
+	if (!sm)
+		return;
+
+	if (g_UpdateSignificanceManager < 0 && IsUpdatedByGame(world, sm))
+		return;
+
+	TArray<FTransform,TInlineAllocator<4>> viewpoints;
+
+	for (auto it = world->GetPlayerControllerIterator(); it; ++it) {
+		APlayerController* pc = it->Get();
+		if (!pc || !pc->IsLocalController())
+			continue;
+
+		FVector location;
+		FRotator rotation;
+		pc->GetPlayerViewPoint(location, rotation);
+
+		viewpoints.Emplace(rotation, location);
+	}
+
+	if (viewpoints.IsEmpty())
+		return;
+
+	sm->Update(viewpoints);
+
+	if (g_UpdateSignificanceManager < 0)
+		s_LastViewpoints.Add(world, TArray<FTransform>(viewpoints));
+}
+
+static void OnWorldCleanup(UWorld* world, bool, bool)
+{
+	s_LastViewpoints.Remove(world);
+	s_WorldsUpdatedByGame.Remove(world);
+}
+
+
+void FRotaryWingAircraftModule::StartupModule()
+{
+	m_PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddStatic(&UpdateSignificanceManager);
+	m_WorldCleanupHandle = FWorldDelegates::OnWorldCleanup.AddStatic(&OnWorldCleanup);
+}
+
+void FRotaryWingAircraftModule::ShutdownModule()
+{
+	FWorldDelegates::OnWorldPostActorTick.Remove(m_PostActorTickHandle);
+	FWorldDelegates::OnWorldCleanup.Remove(m_WorldCleanupHandle);
+}
+
+
 IMPLEMENT_MODULE(FRotaryWingAircraftModule, RotaryWingAircraft)
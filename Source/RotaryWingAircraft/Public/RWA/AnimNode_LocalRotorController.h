@@ -0,0 +1,60 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Animation/AnimNodeBase.h"
+#include "AnimNode_LocalRotorController.generated.h"
+
+struct FRWA_HeliAnimInstanceProxy;
+
+
+struct FRWA_LocalRotorLookupData
+{
+	int32 Index = INDEX_NONE;
+	FCompactPoseBoneIndex BoneIndex = FCompactPoseBoneIndex(INDEX_NONE);
+	/** The rotor's torque normal, expressed in the bone's (reference) parent space */
+	FVector LocalAxis = FVector::UpVector;
+
+	FRWA_LocalRotorLookupData() = default;
+	FRWA_LocalRotorLookupData(int32 idx, FCompactPoseBoneIndex boneIdx, FVector const& axis)
+		: Index(idx)
+		, BoneIndex(boneIdx)
+		, LocalAxis(axis)
+	{}
+};
+
+
+/**
+ * Local-space variant of the Rotor Controller. Rotor rotations are applied
+ * directly to the bone-space pose, so unlike the skeletal-control version, this
+ * node doesn't force a component-space conversion of the whole skeleton.
+ *
+ * Rotor torque normals are converted from component space to each rotor bone's
+ * parent space using the reference pose. If the ancestors of a rotor bone are
+ * animated, use the skeletal-control Rotor Controller instead.
+ */
+USTRUCT()
+struct ROTARYWINGAIRCRAFT_API FAnimNode_RWA_LocalRotorController
+	: public FAnimNode_Base
+{
+	GENERATED_BODY()
+
+public:
+	UPROPERTY(EditAnywhere, Category="Links")
+	FPoseLink Source;
+
+	FAnimNode_RWA_LocalRotorController() = default;
+
+	void Initialize_AnyThread(FAnimationInitializeContext const& ctx) override;
+	void CacheBones_AnyThread(FAnimationCacheBonesContext const& ctx) override;
+	void Update_AnyThread(FAnimationUpdateContext const& ctx) override;
+	void Evaluate_AnyThread(FPoseContext& output) override;
+	void GatherDebugData(FNodeDebugData& data) override;
+
+private:
+	FRWA_HeliAnimInstanceProxy const* m_Proxy = nullptr;
+	TArray<FRWA_LocalRotorLookupData> m_Rotors = {};
+	/** The proxy's rotor setup serial when m_Rotors was built */
+	uint32 m_RotorSetupSerial = 0;
+
+	void CacheRotors(FBoneContainer const& requiredBones);
+};
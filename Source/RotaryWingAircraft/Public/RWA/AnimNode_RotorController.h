@@ -1,4 +1,4 @@
-#pragma once
+﻿#pragma once
 
 #include "CoreMinimal.h"
 #include "BoneControllers/AnimNode_SkeletalControlBase.h"
@@ -7,19 +7,34 @@
 struct FRWA_HeliAnimInstanceProxy;
 
 
+enum class ERWA_RotorBone : uint8
+{
+	Rotor,
+	Swashplate,
+	Blade,
+};
+
+
 struct FRWA_RotorLookupData
 {
 	int32 Index;
 	FBoneReference BoneRef;
+	ERWA_RotorBone Kind = ERWA_RotorBone::Rotor;
 
 	FRWA_RotorLookupData() = default;
-	FRWA_RotorLookupData(int32 idx, FBoneReference const& boneRef)
+	FRWA_RotorLookupData(int32 idx, FBoneReference const& boneRef, ERWA_RotorBone kind)
 		: Index(idx)
 		, BoneRef(boneRef)
+		, Kind(kind)
 	{}
 };
 
 
+/**
+ * Spins the aircraft's rotors, and animates their control linkages (swashplate
+ * tilt, blade pitch and coning) from the cyclic and collective, writing every
+ * bone in a single batch.
+ */
 USTRUCT()
 struct ROTARYWINGAIRCRAFT_API FAnimNode_RWA_RotorController
 	: public FAnimNode_SkeletalControlBase
@@ -45,6 +60,8 @@ public:
 private:
 	FRWA_HeliAnimInstanceProxy const* m_Proxy = nullptr;
 	TArray<FRWA_RotorLookupData> m_Rotors = {};
+	/** The proxy's rotor setup serial when m_Rotors was built */
+	uint32 m_RotorSetupSerial = 0;
 
 	void InitializeBoneReferences(FBoneContainer const& requiredBones) override;
 };
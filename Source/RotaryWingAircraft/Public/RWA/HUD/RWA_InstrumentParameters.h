@@ -0,0 +1,129 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "Components/ActorComponent.h"
+
+#include "RWA_InstrumentParameters.generated.h"
+
+struct FRWA_FlightInstruments;
+class UMaterialParameterCollection;
+class UMaterialParameterCollectionInstance;
+class URWA_HeliMovementComponent;
+
+
+UENUM(BlueprintType, DisplayName="Flight Instrument")
+enum class ERWA_FlightInstrument : uint8
+{
+	Airspeed,
+	AirspeedKnots,
+	VerticalSpeed,
+	Heading,
+	Pitch,
+	Bank,
+	RadarAltitude UMETA(DisplayName="AGL"),
+	RPM,
+	GLoad UMETA(DisplayName="G-Load"),
+	Collective,
+	CyclicRoll,
+	CyclicPitch,
+	AntiTorque UMETA(DisplayName="Anti-Torque"),
+};
+
+
+USTRUCT(BlueprintType, DisplayName="Instrument Parameter Binding")
+struct ROTARYWINGAIRCRAFT_API FRWA_InstrumentParameterBinding
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Binding")
+	ERWA_FlightInstrument Source = ERWA_FlightInstrument::Airspeed;
+
+	/** The name of the scalar parameter in the Parameter Collection */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Binding")
+	FName ParameterName = EName::None;
+
+	/**
+	 * Values are snapped to the nearest multiple of this step before being
+	 * written, and unchanged values are skipped entirely. Use the coarsest step
+	 * that the gauge can actually display. A value of 0 disables quantization.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Binding", meta=(
+		UIMin="0", ClampMin="0"))
+	float Quantization = 0;
+
+	/**
+	 * The maximum number of times per second this parameter is updated. A value
+	 * of 0 updates it every tick.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Binding", meta=(
+		UIMin="0", ClampMin="0", Units="Hz"))
+	float UpdateFrequency = 0;
+};
+
+
+/**
+ * Pushes the owning aircraft's flight instrument values into a Material
+ * Parameter Collection (e.g. `MPC_HUD`) once per tick.
+ *
+ * Every change to a parameter collection forces a uniform buffer update on the
+ * render thread, so values that haven't changed (after quantization) since the
+ * last write are skipped. The remaining writes all land in the same tick, so
+ * the collection only updates its uniform buffer once for them.
+ */
+UCLASS(
+	ClassGroup=(Custom),
+	DisplayName="Instrument Parameter Component",
+	meta=(BlueprintSpawnableComponent)
+)
+class ROTARYWINGAIRCRAFT_API URWA_InstrumentParameterComponent
+	: public UActorComponent
+{
+	GENERATED_BODY()
+
+public:
+	using TickFn = FActorComponentTickFunction;
+
+	URWA_InstrumentParameterComponent();
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Instruments")
+	TObjectPtr<UMaterialParameterCollection> ParameterCollection;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Instruments")
+	TArray<FRWA_InstrumentParameterBinding> Bindings;
+
+	/**
+	 * Only update the parameter collection while the owning pawn is locally
+	 * controlled. Parameter collections are shared by the whole world, so this
+	 * should almost always be enabled.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Instruments")
+	bool OnlyWhenLocallyControlled = true;
+
+	/** Write every bound parameter on the next tick, whether it changed or not. */
+	UFUNCTION(BlueprintCallable, Category="Instruments")
+	void ForceUpdate();
+
+	void TickComponent(float deltaTime, ELevelTick type, TickFn* fn) override;
+
+protected:
+	void BeginPlay() override;
+
+private:
+	struct FBindingState
+	{
+		float LastValue = 0;
+		double NextUpdateTime = 0;
+		bool Written = false;
+	};
+
+	TArray<FBindingState> m_BindingStates;
+
+	TWeakObjectPtr<URWA_HeliMovementComponent> m_MovementComponent;
+	TWeakObjectPtr<UMaterialParameterCollectionInstance> m_CollectionInstance;
+
+	void ResetBindingStates();
+
+	static float GetInstrumentValue(
+		FRWA_FlightInstruments const& instruments,
+		ERWA_FlightInstrument source);
+};
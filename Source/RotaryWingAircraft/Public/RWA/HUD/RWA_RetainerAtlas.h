@@ -0,0 +1,120 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+#include "UObject/GCObject.h"
+
+class UTextureRenderTarget2D;
+
+
+/** A region of one of the atlas pool's render targets, owned by a single retainer. */
+struct FRWA_RetainerAtlasSlot
+{
+	int32 Page = INDEX_NONE;
+	FIntRect Rect = {};
+
+	bool IsValid() const { return Page != INDEX_NONE; }
+
+	/** The top-left corner of the slot's content, inside the padding */
+	FIntPoint GetContentOrigin() const;
+};
+
+
+/**
+ * Packs the content of many retainer widgets into a few shared render targets
+ * ("pages"), so a HUD built from lots of small retained panels doesn't pay for
+ * a render target, and a GPU allocation, per panel.
+ *
+ * Retainers with different pixel formats never share a page.
+ *
+ * Pages are packed with shelves: slots are placed left-to-right on horizontal
+ * strips whose height is set by their first slot. Slot sizes are rounded up to
+ * a fixed granularity, so a retainer keeps its slot through small size changes,
+ * and a new page is only allocated when none of the existing pages has room.
+ *
+ * Creating a render target can flush the render thread, so new pages get their
+ * render target at the end of the frame (see ApplyPendingPages), and until then
+ * GetRenderTarget returns null for them. Pages left empty are freed there too.
+ *
+ * The pool also keeps a few spare render targets released by idle retainers
+ * (see `Slate.RWARetainerPoolReleasedTargets`), for the next retainer that
+ * needs its own.
+ */
+class ROTARYWINGAIRCRAFT_API FRWA_RetainerAtlasPool
+	: public FGCObject
+{
+public:
+	/** Empty space kept around each slot, so filtering doesn't bleed between neighbours */
+	inline static constexpr
+	int32 k_Padding = 2;
+
+	static FRWA_RetainerAtlasPool& Get();
+
+	/**
+	 * Make sure `inout_slot` can hold content of the given size, keeping the
+	 * current slot when it's still big enough. Returns false (and releases the
+	 * slot) if the content is too big to be packed into a page.
+	 */
+	bool Allocate(FIntPoint size, EPixelFormat format, FRWA_RetainerAtlasSlot& inout_slot);
+	void Release(FRWA_RetainerAtlasSlot& inout_slot);
+
+	/** Null while the page is waiting for its render target */
+	UTextureRenderTarget2D* GetRenderTarget(int32 page) const;
+
+	/**
+	 * Create the render targets of pages added since the last call, and free
+	 * the pages nobody is using anymore. Call once the frame's painting is done.
+	 */
+	void ApplyPendingPages();
+
+	/** Keep a retainer's render target for reuse, dropping the oldest spare if there are too many */
+	void ReturnRenderTarget(UTextureRenderTarget2D* rt);
+
+	/** Take a spare render target, preferring one with the given format. May return null. */
+	UTextureRenderTarget2D* TakeRenderTarget(EPixelFormat format);
+
+	/**
+	 * Clear a region of a render target to transparent black. Retainers drawing
+	 * into part of a shared target can't let the widget renderer clear the whole
+	 * thing.
+	 */
+	static void ClearRegion(UTextureRenderTarget2D* rt, FIntRect const& rect);
+
+	void AddReferencedObjects(FReferenceCollector& collector) override;
+	FString GetReferencerName() const override;
+
+private:
+	inline static constexpr
+	int32 k_Granularity = 16;
+
+	inline static constexpr
+	int32 k_MaxSpareTargets = 4;
+
+	struct FShelf
+	{
+		int32 Y = 0;
+		int32 Height = 0;
+		/** The left edge of the shelf's free space */
+		int32 X = 0;
+	};
+
+	struct FPage
+	{
+		/** Null until the end of the frame the page was added in */
+		TObjectPtr<UTextureRenderTarget2D> RenderTarget = nullptr;
+		/** 0 when the page has been freed, and its index can be reused */
+		int32 Size = 0;
+		EPixelFormat Format = PF_Unknown;
+		int32 NumSlots = 0;
+		int32 NextShelfY = 0;
+		TArray<FShelf> Shelves;
+		/** Released slots that couldn't be given back to their shelf */
+		TArray<FIntRect> FreeRects;
+	};
+
+	TArray<FPage> m_Pages;
+	TArray<TObjectPtr<UTextureRenderTarget2D>> m_SpareTargets;
+
+	static bool TryAllocate(FPage& page, FIntPoint size, FIntRect& out_rect);
+	static int32 GetPageSize();
+	int32 AddPage(int32 size, EPixelFormat format);
+};
@@ -2,6 +2,7 @@
 
 #include "CoreMinimal.h"
 #include "Components/ContentWidget.h"
+#include "RWA/HUD/RWA_RetainerFormat.h"
 
 #include "RWA_RetainerBox.generated.h"
 
@@ -58,6 +59,69 @@ public:
 	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Render Rules", meta=(UIMin=1, ClampMin=1))
 	int32 PhaseCount = 1;
 
+	/**
+	 * Pick the PhaseCount automatically instead, from how often the content
+	 * actually changes and how long it takes to draw. Slow gauges settle at the
+	 * Max Phase Count, while content that changes every frame stays at the Min.
+	 * Adaptive retainers are spread across phases so they don't all redraw on
+	 * the same frame.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Render Rules", meta=(EditCondition="RenderOnPhase && RetainedRendering"))
+	bool AdaptivePhase = false;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Render Rules", meta=(EditCondition="AdaptivePhase && RenderOnPhase && RetainedRendering", UIMin=1, ClampMin=1))
+	int32 MinPhaseCount = 1;
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Render Rules", meta=(EditCondition="AdaptivePhase && RenderOnPhase && RetainedRendering", UIMin=1, ClampMin=1))
+	int32 MaxPhaseCount = 8;
+
+	/**
+	 * Draw into a region of a render target shared with other retainers,
+	 * instead of allocating one just for this widget. Recommended for the many
+	 * small panels that make up a HUD. Content too large to fit in an atlas page
+	 * (see `Slate.RWARetainerAtlasPageSize`) gets its own render target anyway.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Render Rules", meta=(EditCondition="RetainedRendering"))
+	bool UseSharedAtlas = false;
+
+	/**
+	 * When the retainer frame budget (`Slate.RWARetainerFrameBudget`) runs out,
+	 * waiting retainers are drawn in order of priority multiplied by the time
+	 * since they last drew. Raise this for critical instruments; no retainer
+	 * waits longer than `Slate.RWARetainerMaxStaleness` regardless.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Render Rules", meta=(EditCondition="RetainedRendering", UIMin=0, ClampMin=0))
+	float Priority = 1;
+
+	/**
+	 * Render the content at a fraction of its on-screen resolution, and
+	 * upsample it when drawing. Thin-line symbology often looks fine at 0.5-0.75
+	 * on high-resolution displays, for a fraction of the fill cost and memory.
+	 * Multiplied by `Slate.RWARetainerRenderScale`.
+	 *
+	 * Only applies when Hit Testable is off. Hit-testable content always renders
+	 * at full scale, so it keeps receiving input.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Render Rules", meta=(EditCondition="RetainedRendering", UIMin=0.1, ClampMin=0.1, UIMax=1, ClampMax=1))
+	float RenderScale = 1;
+
+	/**
+	 * The pixel format of the render target. R8 and RG8 only store coverage,
+	 * for single-color symbology that the Effect Material tints, and fall back
+	 * to RGBA8 when there's no Effect Material. RGB10A2 and Float RGBA are for
+	 * HDR HUDs.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Render Rules", meta=(EditCondition="RetainedRendering"))
+	ERWA_RetainerFormat Format = ERWA_RetainerFormat::RGBA8;
+
+	/**
+	 * Can the content receive input? Turn this off for purely visual layers,
+	 * like a flight HUD, to skip building and merging a hit-test grid for the
+	 * content every time the retainer is painted.
+	 */
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category="Render Rules", meta=(EditCondition="RetainedRendering"))
+	bool HitTestable = true;
+
 public:
 	UFUNCTION(BlueprintCallable, Category="Retainer")
 	void SetRetainedRendering(bool value);
@@ -65,9 +129,35 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Retainer")
 	void SetRenderingPhase(int32 in_phase, int32 in_phaseCount);
 
+	UFUNCTION(BlueprintCallable, Category="Retainer")
+	void SetAdaptivePhase(bool enabled, int32 minPhaseCount = 1, int32 maxPhaseCount = 8);
+
+	UFUNCTION(BlueprintCallable, Category="Retainer")
+	void SetPriority(float value);
+
+	UFUNCTION(BlueprintCallable, Category="Retainer")
+	void SetRenderScale(float value);
+
+	UFUNCTION(BlueprintCallable, Category="Retainer")
+	void SetFormat(ERWA_RetainerFormat value);
+
 	UFUNCTION(BlueprintCallable, Category="Retainer")
 	void RequestRender();
 
+	/**
+	 * Redraw only the area covered by the given widget (a descendant of this
+	 * retainer) next time the retainer is painted, e.g. when a numeric readout
+	 * changes. Much cheaper than RequestRender for large panels, as long as
+	 * nothing else needs to be redrawn. The content's own invalidations don't
+	 * mark regions, so call this whenever the widget changes.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Retainer")
+	void InvalidateWidgetRegion(UWidget* widget);
+
+	/** Redraw only the given region (in the retainer's local space) next time it's painted. */
+	UFUNCTION(BlueprintCallable, Category="Retainer")
+	void InvalidateRegion(FVector2D position, FVector2D size);
+
 	UFUNCTION(BlueprintPure, Category="Retainer|Effect")
 	UMaterialInstanceDynamic* GetEffectMaterial() const;
 
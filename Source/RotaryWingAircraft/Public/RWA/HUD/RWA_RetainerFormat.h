@@ -0,0 +1,57 @@
+﻿#pragma once
+
+#include "CoreMinimal.h"
+
+#include "RWA_RetainerFormat.generated.h"
+
+
+/** The pixel format of a retainer widget's render target */
+UENUM(BlueprintType, DisplayName="Retainer Format")
+enum class ERWA_RetainerFormat : uint8
+{
+	/** 8-bit color and alpha */
+	RGBA8,
+
+	/**
+	 * A single 8-bit channel. Draw the content in white, and the red channel
+	 * holds its coverage, for the Effect Material to tint. A quarter of the
+	 * memory of RGBA8.
+	 */
+	R8,
+
+	/**
+	 * Two 8-bit channels. Draw the content in red and green, e.g. for two-tone
+	 * symbology, and the Effect Material tints each channel. Half the memory of
+	 * RGBA8.
+	 */
+	RG8,
+
+	/** 10-bit color with 2-bit alpha, for HDR HUDs */
+	RGB10A2 UMETA(DisplayName="RGB10A2"),
+
+	/** 16-bit floating-point color and alpha, for HDR HUDs */
+	FloatRGBA UMETA(DisplayName="Float RGBA"),
+};
+
+
+namespace RWA::HUD {
+
+inline EPixelFormat GetPixelFormat(ERWA_RetainerFormat format)
+{
+	switch (format) {
+		case ERWA_RetainerFormat::R8: return PF_G8;
+		case ERWA_RetainerFormat::RG8: return PF_R8G8;
+		case ERWA_RetainerFormat::RGB10A2: return PF_A2B10G10R10;
+		case ERWA_RetainerFormat::FloatRGBA: return PF_FloatRGBA;
+		default: return PF_B8G8R8A8;
+	}
+}
+
+/** Whether the format only stores coverage, and needs an Effect Material to be tinted */
+inline bool IsCoverageFormat(ERWA_RetainerFormat format)
+{
+	return format == ERWA_RetainerFormat::R8
+		|| format == ERWA_RetainerFormat::RG8;
+}
+
+}
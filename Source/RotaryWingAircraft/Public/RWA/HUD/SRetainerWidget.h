@@ -1,12 +1,32 @@
 ﻿#pragma once
 
 #include "CoreMinimal.h"
+#include "RWA/HUD/RWA_RetainerFormat.h"
 
 class SVirtualWindow;
 class FRWA_RenderResources;
 
 DECLARE_MULTICAST_DELEGATE(FRWA_OnRetainedModeChanged);
 
+
+/** Counters kept by each retainer for profiling. Times are in microseconds. */
+struct FRWA_RetainerStats
+{
+	/** Time spent in the last retained paint, including drawing the content */
+	double PaintTime = 0;
+	/** Time spent in DrawInvalidationRoot the last time the content was drawn */
+	double DrawTime = 0;
+	/** Draws that repainted the content */
+	int64 NumRedraws = 0;
+	/** Paints that showed the retained content without repainting it */
+	int64 NumSkipped = 0;
+	/** Paints whose draw was deferred by the frame budget */
+	int64 NumQueued = 0;
+	/** Render target (re)allocations and atlas slot changes */
+	int64 NumResizes = 0;
+};
+
+
 class ROTARYWINGAIRCRAFT_API SRWA_RetainerWidget
 	: public SCompoundWidget
 	, public FSlateInvalidationRoot
@@ -17,8 +37,6 @@ private:
 	using RenderResources = FRWA_RenderResources;
 	
 public:
-	static int32 s_MaxRetainerWorkPerFrame;
-
 	SLATE_BEGIN_ARGS(SRWA_RetainerWidget)
 	{
 		_Visibility = EVisibility::SelfHitTestInvisible;
@@ -27,6 +45,14 @@ public:
 		_RenderOnPhase = true;
 		_RenderOnInvalidation = false;
 		_RenderWithLocalTransform = true;
+		_UseSharedAtlas = false;
+		_Priority = 1.f;
+		_AdaptivePhase = false;
+		_MinPhaseCount = 1;
+		_MaxPhaseCount = 8;
+		_RenderScale = 1.f;
+		_Format = ERWA_RetainerFormat::RGBA8;
+		_HitTestable = true;
 	}
 	SLATE_DEFAULT_SLOT(FArguments, Content)
 		SLATE_ARGUMENT(bool, RenderOnPhase)
@@ -34,6 +60,14 @@ public:
 		SLATE_ARGUMENT(bool, RenderWithLocalTransform)
 		SLATE_ARGUMENT(int32, Phase)
 		SLATE_ARGUMENT(int32, PhaseCount)
+		SLATE_ARGUMENT(bool, UseSharedAtlas)
+		SLATE_ARGUMENT(float, Priority)
+		SLATE_ARGUMENT(bool, AdaptivePhase)
+		SLATE_ARGUMENT(int32, MinPhaseCount)
+		SLATE_ARGUMENT(int32, MaxPhaseCount)
+		SLATE_ARGUMENT(float, RenderScale)
+		SLATE_ARGUMENT(ERWA_RetainerFormat, Format)
+		SLATE_ARGUMENT(bool, HitTestable)
 		SLATE_ARGUMENT(FName, StatId)
 	SLATE_END_ARGS()
 
@@ -45,8 +79,62 @@ public:
 	/** Requests that the retainer redraw the hosted content next time it's painted. */
 	void RequestRender();
 
+	/**
+	 * Requests that the retainer redraw only the given region of its content
+	 * (in local space) next time it's painted. Regions accumulate until then.
+	 * If anything else requests a render in the meantime, or the regions cover
+	 * too much of the content, everything is redrawn as usual. A phase-driven
+	 * render doesn't count, so it just draws the regions.
+	 *
+	 * Regions only come from this and InvalidateWidgetRegion. The content's own
+	 * invalidations don't produce them.
+	 */
+	void InvalidateRegion(FSlateRect const& localRect);
+
+	/**
+	 * Requests that the retainer redraw only the area covered by one of its
+	 * descendants. If the widget grows before the draw, the area grows with it.
+	 */
+	void InvalidateWidgetRegion(SWidget const& widget);
+
 	void SetRenderingPhase(int32 phase, int32 phaseCount);
+
+	/**
+	 * Choose the phase count automatically, between the given bounds, from how
+	 * often the content actually changes and how expensive it is to draw.
+	 */
+	void SetAdaptivePhase(bool enabled, int32 minPhaseCount, int32 maxPhaseCount);
 	void SetRetainedRendering(bool value);
+	void SetUseSharedAtlas(bool value);
+	void SetPriority(float value);
+
+	/**
+	 * Render the content at a fraction of its on-screen resolution. It's
+	 * upsampled when the render target is drawn. Only applies when rendering
+	 * with the local transform, and the content isn't hit-testable.
+	 */
+	void SetRenderScale(float value);
+
+	/**
+	 * Set the pixel format of the render target. Coverage-only formats (R8 and
+	 * RG8) fall back to RGBA8 without an effect material to tint them.
+	 */
+	void SetFormat(ERWA_RetainerFormat value);
+
+	/**
+	 * When disabled, the content isn't added to the hit-test grid at all, which
+	 * saves building and merging a nested grid every paint. For purely visual
+	 * layers that never receive input.
+	 */
+	void SetHitTestable(bool value);
+
+	FRWA_RetainerStats const& GetStats() const { return m_Stats; }
+
+	/** The memory used by our render target, or by our slot of a shared atlas page */
+	int64 GetRenderTargetBytes() const;
+
+	/** Print the stats of every live retainer, most expensive first. See `Slate.RWADumpRetainers`. */
+	static void DumpLiveRetainers(FOutputDevice& ar);
 	void SetContent(TSharedRef<SWidget> const& content);
 	void SetTextureParameter(FName value);
 	void SetWorld(UWorld* value);
@@ -107,6 +195,63 @@ private:
 	void OnGlobalInvalidationToggled(bool value);
 	void UpdateWidgetRenderer();
 
+	/**
+	 * Get the render target to draw into, (re)allocating it if needed, and set
+	 * m_TargetRect to the region of it that the content will occupy.
+	 */
+	UTextureRenderTarget2D* UpdateRenderTarget(FIntPoint size);
+
+	static FIntPoint GetBucketedSize(FIntPoint size);
+	static void ResizeRenderTarget(UTextureRenderTarget2D* rt, FIntPoint size, EPixelFormat format);
+
+	void RequestFullRedraw();
+
+	/** The region to redraw in place of the whole content, if any, in render target pixels */
+	TOptional<FIntRect> GetDirtyRect(FIntPoint size) const;
+	/** Add the area a widget was painted over to the dirty region, extended to the given local size */
+	void AddWidgetDirtyRegion(SWidget const& widget, FVector2f localSize);
+
+	/** The pixel format actually used for the render target */
+	EPixelFormat GetPixelFormat() const;
+
+	UTextureRenderTarget2D* GetOrCreateRenderTarget();
+
+	bool HasRenderResources() const;
+
+	/**
+	 * Give up the render target (or atlas slot) and widget renderer. They're
+	 * created again the next time the content is drawn.
+	 */
+	void ReleaseRenderResources();
+
+	/** Releases the resources of retainers that haven't been painted for a while */
+	static bool ReleaseIdleRenderResources(float deltaTime);
+
+	/** Reallocates the render targets of retainers that outgrew them, at the end of the frame */
+	static void ApplyPendingResizes();
+
+	/** Updates the stats that cover every retainer, at the end of the frame */
+	static void PublishFrameStats();
+
+	void RecordResize();
+
+	/** The StatId we were constructed with, or a description of the widget */
+	FString GetDebugName() const;
+
+	/**
+	 * Whether there's enough of the frame's retainer budget left to draw,
+	 * after setting aside time for the queued retainers ahead of us.
+	 */
+	bool HasBudgetToDraw(double now) const;
+
+	void UpdateAdaptivePhase(bool repainted);
+
+	/** The render scale after applying the global scalability setting. Always 1 while hit-testable. */
+	float GetEffectiveRenderScale() const;
+
+	/** Queued retainers with a higher score are drawn first. */
+	double GetDrawScore(double now) const;
+
 #if !UE_BUILD_SHIPPING
 	static void OnRetainerModeCVarChanged(IConsoleVariable* cvar);
 	static FRWA_OnRetainedModeChanged s_OnRetainedModeChangedDelegate;
@@ -128,29 +273,91 @@ private:
 	int32 m_Phase;
 	int32 m_PhaseCount;
 
+	// Adaptive phase --------------------------------------------------------------
+
+	/** The number of frames over which content changes are counted */
+	inline static constexpr
+	int32 k_AdaptiveWindowFrames = 60;
+
+	/** Retainers that draw faster than this (in microseconds) redraw twice as often */
+	inline static constexpr
+	double k_AdaptiveCheapDrawCost = 100;
+
+	bool m_AdaptivePhase;
+	int32 m_MinPhaseCount;
+	int32 m_MaxPhaseCount;
+	/** Spreads adaptive retainers across phases, so they don't all redraw on the same frame */
+	int32 m_StaggerIndex;
+	int64 m_AdaptiveWindowStart;
+	int32 m_AdaptiveDraws;
+	int32 m_AdaptiveChanges;
+
+	static int32 s_NextStaggerIndex;
+
 	bool m_EnableRetainedRenderingDesire;
 	bool m_EnableRetainedRendering;
 	bool m_EnableRenderWithLocalTransform;
+	bool m_UseSharedAtlas;
+	bool m_HitTestable;
+
+	ERWA_RetainerFormat m_Format;
+	float m_RenderScale;
+	/** The effective render scale the retained content was last drawn at */
+	float m_AppliedRenderScale;
 
 	bool m_RenderOnPhase;
 	bool m_RenderOnInvalidation;
 
 	bool m_RenderRequested;
+	bool m_FullRedrawRequested;
+	/** Set when the content was last painted clipped to a dirty region */
+	bool m_ContentCacheClipped;
+	/** Set when the prepass found invalidated widgets in the content since the last draw */
+	bool m_ContentInvalidated;
 	bool m_InvalidSizeLogged;
 
 	double m_LastDrawTime;
+	double m_LastPaintTime;
 	int64 m_LastTickedFrame;
+	int64 m_LastQueuedFrame;
+	/** When the pending draw was first checked against the budget, or -1 if there's none */
+	double m_WaitStartTime;
+
+	float m_Priority;
+	/** Moving average of the time spent in DrawInvalidationRoot, in microseconds */
+	double m_DrawCost;
+
+	/** The region of the render target holding our content */
+	FIntRect m_TargetRect;
+	/** The size our render target will be reallocated to at the end of the frame, if any */
+	FIntPoint m_PendingTargetSize;
+	/** Set while painting into part of a larger render target, to keep the content inside its region */
+	TOptional<FSlateRect> m_ContentClipRect;
+
+	/** The union of the regions invalidated since the last draw, in render target pixels relative to the content */
+	TOptional<FSlateRect> m_DirtyRegion;
+	/** The widgets passed to InvalidateWidgetRegion since the last draw, to cover their new size once it's known */
+	TArray<TWeakPtr<SWidget const>> m_DirtyWidgets;
+	/** The window-space position and scale the content was last painted at */
+	FVector2f m_ContentOrigin;
+	FVector2f m_ContentScale;
 
 	TWeakObjectPtr<UWorld> m_OuterWorld;
 	
 	RenderResources* m_RenderResources;
 
 	STAT(TStatId m_StatId);
+	STAT(TStatId m_DrawStatId);
+	FName m_StatName;
+	FRWA_RetainerStats m_Stats;
 
 	FSlateBrush m_DynamicBrush;
 
 	FName m_DynamicEffectTextureParam;
 
 	static TArray<Self*,TInlineAllocator<3>> s_WaitingToRender;
-	static TFrameValue<int32> s_RetainerWorkThisFrame;
+	/** Time spent drawing retainers this frame, in microseconds */
+	static TFrameValue<double> s_RetainerTimeThisFrame;
+	static TArray<Self*> s_PendingResizes;
+	static TArray<Self*> s_LiveRetainers;
 };
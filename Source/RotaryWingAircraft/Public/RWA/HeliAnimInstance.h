@@ -2,24 +2,62 @@
 
 #include "CoreMinimal.h"
 #include "Animation/AnimInstanceProxy.h"
+#include "RWA/HeliMovement.h"
 #include "HeliAnimInstance.generated.h"
 
 class ARWA_Heli;
-class URWA_HeliMovementComponent;
-struct FRWA_RotorSetup;
+enum class EVisibilityBasedAnimTickOption : uint8;
 
 
 struct FRWA_RotorAnimData
 {
 	FName BoneName = EName::None;
-	FRotator Rotation = FRotator::ZeroRotator;
 	FVector TorqueNormal = FVector::UpVector;
+	float GearRatio = 1;
+	float BlurRPM = 0;
+	FName BlurParameter = EName::None;
+	bool CounterRotating = false;
+	FRWA_RotorLinkageSetup Linkage = {};
+	/** When set, the rotor is displayed as a blurred disc and its bone isn't animated */
+	bool IsBlurred = false;
 
 	FRWA_RotorAnimData() = default;
 	FRWA_RotorAnimData(FRWA_RotorSetup const& rotor);
 };
 
 
+/**
+ * Values copied from the movement component on the game thread, so that the
+ * proxy's update never needs to touch a UObject from a worker thread.
+ */
+struct FRWA_HeliAnimInputs
+{
+	float RPM = 0;
+	float NominalRPM = 0;
+	float Collective = 0;
+	FVector2D Cyclic = FVector2D::ZeroVector;
+	double WorldTime = -1;
+	/** The rotors are only advanced every this many frames (see Rotor LOD) */
+	int32 RotorUpdateInterval = 1;
+	/** Offsets the frames the rotors are advanced on, so throttled aircraft don't all update together */
+	int32 RotorUpdatePhase = 0;
+	uint64 FrameCounter = 0;
+	bool IsValid = false;
+};
+
+
+/** Per-rotor control linkage pose, derived from the inputs. Angles are in radians. */
+struct FRWA_RotorLinkageState
+{
+	FQuat SwashplateTilt = FQuat::Identity;
+	FVector SwashplateOffset = FVector::ZeroVector;
+	float CollectivePitch = 0;
+	/** Dotted with a blade's span direction to get its cyclic pitch */
+	FVector CyclicPitchAxis = FVector::ZeroVector;
+	float ConingAngle = 0;
+};
+
+
 USTRUCT()
 struct ROTARYWINGAIRCRAFT_API FRWA_HeliAnimInstanceProxy
 	: public FAnimInstanceProxy
@@ -30,17 +68,60 @@ struct ROTARYWINGAIRCRAFT_API FRWA_HeliAnimInstanceProxy
 	FRWA_HeliAnimInstanceProxy(UAnimInstance* inst) : Super(inst) {}
 
 public:
-	void SetMovementComponent(URWA_HeliMovementComponent const* mc);
-	void PreUpdate(UAnimInstance* instance, float deltaTime) override;
 	TArray<FRWA_RotorAnimData> const& GetAnimData() const;
+	FRWA_HeliAnimInputs const& GetInputs() const;
+	FRWA_RotorLinkageState const& GetLinkageState(int32 idx) const;
+
+	/**
+	 * Changes whenever the rotor setup is copied from the movement component.
+	 * Anim nodes caching rotor indices must rebuild them when this changes.
+	 */
+	uint32 GetRotorSetupSerial() const { return m_RotorSetupSerial; }
+
+	/**
+	 * Get the current rotation of the rotor at the given index (matching the
+	 * order of GetAnimData) around the given axis.
+	 */
+	FORCEINLINE FQuat GetRotorRotation(int32 idx, FVector const& axis) const
+	{
+		float s = m_RotorSinHalf[idx];
+		return { axis.X * s, axis.Y * s, axis.Z * s, m_RotorCosHalf[idx] };
+	}
+
+protected:
+	void PreUpdate(UAnimInstance* instance, float deltaTime) override;
+	void Update(float deltaTime) override;
 
 private:
 	inline static constexpr
 	float k_RpmToRadsPerSec = 0.10472;
 
+	inline static constexpr
+	float k_BlurHysteresis = 0.95f;
+
+	using FAlignedFloats = TArray<float, TAlignedHeapAllocator<16>>;
+
 	TArray<FRWA_RotorAnimData> m_RotorInstances = {};
-	float m_RotorSpeed = 0;
-	float m_RotorAngle = 0;
+	TArray<FRWA_RotorLinkageState> m_LinkageStates = {};
+	FRWA_HeliAnimInputs m_Inputs = {};
+	uint32 m_RotorSetupSerial = 0;
+
+	// Per-rotor state, stored as a structure of arrays padded to a multiple of
+	// four so every rotor can be advanced in a single SIMD loop
+	FAlignedFloats m_RotorRates = {};
+	FAlignedFloats m_RotorAngles = {};
+	FAlignedFloats m_RotorSinHalf = {};
+	FAlignedFloats m_RotorCosHalf = {};
+
+	// Rotor angles are integrated from elapsed world time rather than the
+	// update's delta time, so updates skipped by the rotor LOD are extrapolated
+	// without affecting the visible rotor speed
+	double m_LastUpdateTime = -1;
+	float m_LastRPM = 0;
+
+	void SetRotorSetup(TArray<FRWA_RotorSetup> const& rotors);
+	void UpdateRotors(float rpm, float deltaTime);
+	void UpdateLinkages();
 };
 
 
@@ -55,8 +136,71 @@ public:
 	void SetMovementComponent(URWA_HeliMovementComponent const* mc);
 	URWA_HeliMovementComponent const* GetMovementComponent() const;
 
+	/**
+	 * Register the aircraft with the Significance Manager, so that the rotors of
+	 * distant aircraft are animated at reduced rates.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Rotor LOD")
+	bool UseSignificance = true;
+
+	/**
+	 * Approximate screen sizes (bounding sphere radius / view distance). Each
+	 * time the aircraft drops below one of these thresholds, its rotors are
+	 * updated half as often. Rotor angles are extrapolated from the RPM, so the
+	 * visible rotor speed is unaffected.
+	 *
+	 * The mesh's whole animation is ticked at the reduced rate through its
+	 * Update Rate Optimizations (see Throttle Mesh Animation). Otherwise only the
+	 * rotor angles are, and the bones are still evaluated every frame.
+	 *
+	 * The Significance Manager has to be updated with the players' viewpoints.
+	 * Unless the game does, the plugin does it (see `RWA.UpdateSignificanceManager`).
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Rotor LOD", meta=(EditCondition="UseSignificance"))
+	TArray<float> RotorLODScreenSizes = { 0.1f, 0.05f, 0.02f };
+
+	/**
+	 * Turn on the mesh's Update Rate Optimizations while registered (they're
+	 * restored afterwards), so the rotor LOD throttles its whole animation. Turn
+	 * this off if the rest of the mesh has to animate every frame. Meshes that
+	 * already use them are always throttled.
+	 */
+	UPROPERTY(EditDefaultsOnly, Category="Rotor LOD", meta=(EditCondition="UseSignificance"))
+	bool ThrottleMeshAnimation = true;
+
+	/** Skip animation evaluation entirely while the aircraft isn't rendered. */
+	UPROPERTY(EditDefaultsOnly, Category="Rotor LOD", meta=(EditCondition="UseSignificance"))
+	bool SkipEvaluationWhenNotRendered = true;
+
+	inline static FName const k_SignificanceTag = "RWA.Heli";
+
 private:
-	FRWA_HeliAnimInstanceProxy m_Proxy = {};
+	friend struct FRWA_HeliAnimInstanceProxy;
+
+	/** Bumped whenever the movement component changes, so the proxy knows to copy its rotor setup */
+	uint32 m_RotorSetupSerial = 0;
+
+	bool m_IsSignificanceRegistered = false;
+	TOptional<EVisibilityBasedAnimTickOption> m_OriginalTickOption;
+
+	/** Set when the rotor LOD drives the mesh's tick rate, holding its previous settings */
+	struct FExternalTickRateState
+	{
+		bool UpdateRateOptimizations = false;
+		bool TickRateControlled = false;
+		bool Interpolate = false;
+		int32 TickRate = 1;
+	};
+	TOptional<FExternalTickRateState> m_OriginalTickRateState;
+
+	/** Used instead of the mesh's tick rate when it doesn't have update rate optimizations */
+	int32 m_RotorUpdateInterval = 1;
+	int32 m_RotorUpdatePhase = 0;
+
+	inline static int32 s_NextRotorUpdatePhase = 0;
+
+	/** The blur state last applied to the mesh's materials, per rotor */
+	TBitArray<> m_AppliedRotorBlur;
 
 	UPROPERTY(Transient, DisplayName="Movement Component")
 	URWA_HeliMovementComponent const* m_MovementComponent;
@@ -65,6 +209,15 @@ private:
 	ARWA_Heli* GetVehicle() const;
 
 	void NativeInitializeAnimation() override;
+	void NativeBeginPlay() override;
+	void NativeUninitializeAnimation() override;
+	void NativeUpdateAnimation(float deltaTime) override;
+
+	void RegisterSignificance();
+	void UnregisterSignificance();
+	void ApplyRotorLOD(float significance);
+	float CalculateSignificance(FTransform const& viewpoint) const;
+	void ApplyRotorBlur();
+
 	FAnimInstanceProxy* CreateAnimInstanceProxy() override;
-	void DestroyAnimInstanceProxy(FAnimInstanceProxy* proxy) override;
 };
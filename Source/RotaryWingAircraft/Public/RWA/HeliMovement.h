@@ -6,6 +6,46 @@
 DECLARE_LOG_CATEGORY_EXTERN(LogHeliMvmt, Log, All);
 
 
+/**
+ * Optional control linkage bones animated alongside the rotor by the Rotor
+ * Controller anim node. Angles are reached at full control deflection.
+ */
+USTRUCT(DisplayName="Rotor Linkage Setup")
+struct ROTARYWINGAIRCRAFT_API FRWA_RotorLinkageSetup
+{
+	GENERATED_BODY()
+
+	/** Tilted by the cyclic and raised by the collective. Leave empty if the rotor has no visible swashplate. */
+	UPROPERTY(EditAnywhere, Category="Linkage")
+	FName SwashplateBoneName = EName::None;
+
+	UPROPERTY(EditAnywhere, Category="Linkage", meta=(Units="Degrees"))
+	float SwashplateMaxTilt = 8;
+
+	/** How far the swashplate slides along the torque normal at full collective. */
+	UPROPERTY(EditAnywhere, Category="Linkage", meta=(Units="Centimeters"))
+	float SwashplateTravel = 0;
+
+	/** Pitched by the collective and cyclic, and flapped upwards (coning) under load. */
+	UPROPERTY(EditAnywhere, Category="Linkage")
+	TArray<FName> BladeBoneNames;
+
+	/** The blades' root-to-tip axis, in each blade bone's local space. Blade pitch is applied around this axis. */
+	UPROPERTY(EditAnywhere, Category="Linkage")
+	FVector BladeSpanAxis = FVector::ForwardVector;
+
+	UPROPERTY(EditAnywhere, Category="Linkage", meta=(Units="Degrees"))
+	float MaxCollectivePitch = 12;
+
+	UPROPERTY(EditAnywhere, Category="Linkage", meta=(Units="Degrees"))
+	float MaxCyclicPitch = 6;
+
+	/** The blades' flapping angle at full collective and rotor speed. */
+	UPROPERTY(EditAnywhere, Category="Linkage", meta=(Units="Degrees"))
+	float MaxConingAngle = 3;
+};
+
+
 USTRUCT(DisplayName="Rotor Setup")
 struct ROTARYWINGAIRCRAFT_API FRWA_RotorSetup
 {
@@ -16,6 +56,134 @@ struct ROTARYWINGAIRCRAFT_API FRWA_RotorSetup
 
 	UPROPERTY(EditAnywhere, Category="Rotor Setup")
 	FVector TorqueNormal = FVector::UpVector;
+
+	/**
+	 * The rotor's speed relative to the engine RPM. Tail rotors typically spin
+	 * around five times faster than the main rotor.
+	 */
+	UPROPERTY(EditAnywhere, Category="Rotor Setup", meta=(UIMin="0", ClampMin="0"))
+	float GearRatio = 1;
+
+	/** Reverses the rotor's direction of spin, e.g. for the lower rotor of a coaxial system. */
+	UPROPERTY(EditAnywhere, Category="Rotor Setup")
+	bool CounterRotating = false;
+
+	/** The rotor's initial angle around its torque normal. */
+	UPROPERTY(EditAnywhere, Category="Rotor Setup", meta=(Units="Degrees"))
+	float PhaseOffset = 0;
+
+	/**
+	 * Above this rotor speed (engine RPM * Gear Ratio), the rotor's blades are
+	 * swapped for a blurred disc: the Blur Parameter is set to 1 on the mesh's
+	 * materials, and the rotor's bone is no longer animated. Use the parameter
+	 * to mask the blade and disc geometry in your materials. A value of 0
+	 * disables the swap.
+	 */
+	UPROPERTY(EditAnywhere, Category="Rotor Setup|Blur", DisplayName="Blur RPM", meta=(
+		UIMin="0", ClampMin="0"))
+	float BlurRPM = 0;
+
+	/**
+	 * The scalar material parameter set when the rotor switches to its blurred
+	 * disc. Defaults to the bone name followed by "Blur" (e.g. MainRotorBlur),
+	 * so each rotor can be blurred independently. Rotors sharing a parameter
+	 * overwrite each other's value.
+	 */
+	UPROPERTY(EditAnywhere, Category="Rotor Setup|Blur")
+	FName BlurParameter = EName::None;
+
+	UPROPERTY(EditAnywhere, Category="Rotor Setup")
+	FRWA_RotorLinkageSetup Linkage;
+};
+
+
+/**
+ * A snapshot of everything the aircraft's instruments display, computed at most
+ * once per frame. Prefer this over the individual getters when binding a HUD.
+ */
+USTRUCT(BlueprintType, DisplayName="Flight Instruments")
+struct ROTARYWINGAIRCRAFT_API FRWA_FlightInstruments
+{
+	GENERATED_BODY()
+
+	/** Lateral airspeed (cm/s) */
+	UPROPERTY(BlueprintReadOnly, Category="Flight Instruments")
+	float Airspeed = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="Flight Instruments")
+	float AirspeedKnots = 0;
+
+	/** Vertical speed (cm/s) */
+	UPROPERTY(BlueprintReadOnly, Category="Flight Instruments")
+	float VerticalSpeed = 0;
+
+	/** Compass heading (degrees, 0-360) */
+	UPROPERTY(BlueprintReadOnly, Category="Flight Instruments")
+	float Heading = 0;
+
+	/** Degrees, positive when nose-up */
+	UPROPERTY(BlueprintReadOnly, Category="Flight Instruments")
+	float Pitch = 0;
+
+	/** Degrees, positive when banking right */
+	UPROPERTY(BlueprintReadOnly, Category="Flight Instruments")
+	float Bank = 0;
+
+	/** Altitude above ground level (cm), or infinity if there's no ground below */
+	UPROPERTY(BlueprintReadOnly, Category="Flight Instruments", DisplayName="AGL")
+	float RadarAltitude = 0;
+
+	UPROPERTY(BlueprintReadOnly, Category="Flight Instruments", DisplayName="RPM")
+	float RPM = 0;
+
+	/** Load factor along the aircraft's up axis (1 = level, unaccelerated flight) */
+	UPROPERTY(BlueprintReadOnly, Category="Flight Instruments", DisplayName="G-Load")
+	float GLoad = 1;
+
+	UPROPERTY(BlueprintReadOnly, Category="Flight Instruments")
+	float Collective = 0;
+
+	/** X: Roll, Y: Pitch */
+	UPROPERTY(BlueprintReadOnly, Category="Flight Instruments")
+	FVector2D Cyclic = FVector2D::ZeroVector;
+
+	UPROPERTY(BlueprintReadOnly, Category="Flight Instruments", DisplayName="Anti-Torque")
+	float AntiTorque = 0;
+};
+
+
+UENUM(BlueprintType, DisplayName="Engine Command")
+enum class ERWA_EngineCommand : uint8
+{
+	None,
+	Start,
+	Stop,
+};
+
+
+/**
+ * Every control input for a single aircraft, applied in one call. Intended for
+ * AI and scripted aircraft that don't go through Enhanced Input.
+ */
+USTRUCT(BlueprintType, DisplayName="Control Frame")
+struct ROTARYWINGAIRCRAFT_API FRWA_ControlFrame
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Control Frame")
+	float Collective = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Control Frame")
+	float Pitch = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Control Frame")
+	float Roll = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Control Frame")
+	float Yaw = 0;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite, Category="Control Frame")
+	ERWA_EngineCommand Engine = ERWA_EngineCommand::None;
 };
 
 
@@ -131,6 +299,14 @@ public:
 	UFUNCTION(BlueprintPure, Category="Components|Movement|Heli")
 	float GetRadarAltitude() const;
 
+	/**
+	 * Get all of the values displayed by the aircraft's instruments in a single
+	 * call. The result is computed on first access each frame and cached, so
+	 * calling this from several widgets or bindings is cheap.
+	 */
+	UFUNCTION(BlueprintPure, Category="Components|Movement|Heli")
+	FRWA_FlightInstruments GetFlightInstruments() const;
+
 
 	// Blueprint Methods --------------------------------------------------------
 
@@ -152,6 +328,22 @@ public:
 	UFUNCTION(BlueprintCallable, Category="Components|Movement|Heli")
 	void SetYawInput(float value);
 
+	/**
+	 * Set every control input (and optionally start or stop the engine) at once.
+	 * Equivalent to calling StartEngine/StopEngine followed by each of the
+	 * Set*Input methods.
+	 */
+	UFUNCTION(BlueprintCallable, Category="Components|Movement|Heli")
+	void ApplyControlFrame(FRWA_ControlFrame const& frame);
+
+	/**
+	 * Apply a buffer of control frames to the corresponding aircraft, e.g. for
+	 * batch-driven AI. Null components are skipped.
+	 */
+	static void ApplyControlFrames(
+		TArrayView<Self* const> components,
+		TArrayView<FRWA_ControlFrame const> frames);
+
 
 	// Lifecycle & Events -------------------------------------------------------
 
@@ -218,13 +410,23 @@ private:
 
 	// Details ------------------------------------------------------------------
 
+	/** The latest input, as set on the game thread */
+	FInput m_GameInput;
+	/** The input simulated by this frame's physics substeps, copied from m_GameInput each tick */
 	FInput m_Input;
+
 	FEngineState m_EngineState;
 	FPhysicsState m_PhysicsState;
 
+	mutable FRWA_FlightInstruments m_Instruments;
+	mutable uint64 m_InstrumentsFrame = MAX_uint64;
+
 	inline static float const k_Gravity = -981;
 	inline static float const k_CmPerSecToKnots = 0.019438;
 
+	void UpdateFlightInstruments(FRWA_FlightInstruments& out_instruments) const;
+	static float HeadingForDirection(FVector const& forward);
+
 	APawn* GetPawn() const;
 	FBodyInstance* GetBodyInstance() const;
 
@@ -105,3 +105,321 @@ public:
 		return FMath::Lerp(d,e,t);
 	}
 };
+
+
+/**
+ * Precomputed form of an FCubicBezier for repeated evaluation. The curve is
+ * stored as polynomial coefficients, plus a small table of samples used to pick
+ * an initial guess when inverting it. Inversion then takes a few
+ * Newton-Raphson steps, bracketed by the table segment so it falls back to
+ * bisection wherever the curve's slope is too flat for Newton to converge.
+ *
+ * Like FCubicBezier::YForX and XForY, inversion assumes the curve is monotonic
+ * along the solved axis.
+ */
+struct FCubicBezierSolver
+{
+public:
+	using Point = FCubicBezier::Point;
+
+	FCubicBezierSolver() : FCubicBezierSolver(FCubicBezier{}) {}
+
+	explicit FCubicBezierSolver(FCubicBezier const& curve)
+	{
+		ComputeCoefficients(curve, A, B, C, D);
+
+		for (int32 i = 0; i < k_NumSamples; ++i) {
+			Point sample = Get(static_cast<float>(i) / (k_NumSamples - 1));
+			m_SamplesX[i] = sample.X;
+			m_SamplesY[i] = sample.Y;
+		}
+	}
+
+	/** Convert the control points to coefficients of `A*t^3 + B*t^2 + C*t + D`. */
+	FORCEINLINE static void ComputeCoefficients(
+		FCubicBezier const& curve,
+		Point& out_a, Point& out_b, Point& out_c, Point& out_d)
+	{
+		auto const& [p0, p1, p2, p3] = curve;
+
+		out_a = (p3 - p0) + (p1 - p2) * 3.f;
+		out_b = (p0 - p1 * 2.f + p2) * 3.f;
+		out_c = (p1 - p0) * 3.f;
+		out_d = p0;
+	}
+
+	FORCEINLINE float Duration() const
+	{
+		return m_SamplesX[k_NumSamples - 1] - m_SamplesX[0];
+	}
+
+	/** Evaluate the curve for the given `t` value. */
+	FORCEINLINE Point Get(float t) const
+	{
+		return ((A * t + B) * t + C) * t + D;
+	}
+
+	/** Find the point along the curve where x == the provided value, and return the corresponding y. */
+	FORCEINLINE float YForX(float x) const
+	{
+		float t = TForX(x);
+		return ((A.Y * t + B.Y) * t + C.Y) * t + D.Y;
+	}
+
+	/** Find the point along the curve where y == the provided value, and return the corresponding x. */
+	FORCEINLINE float XForY(float y) const
+	{
+		float t = TForY(y);
+		return ((A.X * t + B.X) * t + C.X) * t + D.X;
+	}
+
+	/**
+	 * Find the `t` value where x == the provided value. Within the curve's
+	 * range, `Get(t).X` is within k_Tolerance of it.
+	 */
+	FORCEINLINE float TForX(float x) const
+	{
+		return SolveT(m_SamplesX, A.X, B.X, C.X, D.X, x);
+	}
+
+	/**
+	 * Find the `t` value where y == the provided value. Within the curve's
+	 * range, `Get(t).Y` is within k_Tolerance of it.
+	 */
+	FORCEINLINE float TForY(float y) const
+	{
+		return SolveT(m_SamplesY, A.Y, B.Y, C.Y, D.Y, y);
+	}
+
+	Point A { 0, 0 };
+	Point B { 0, 0 };
+	Point C { 0, 0 };
+	Point D { 0, 0 };
+
+	inline static constexpr int32 k_NumSamples = 11;
+	inline static constexpr int32 k_MaxIterations = 8;
+	inline static constexpr float k_Tolerance = 1e-5f;
+
+private:
+	float m_SamplesX[k_NumSamples] = {};
+	float m_SamplesY[k_NumSamples] = {};
+
+	static float SolveT(
+		float const (&samples)[k_NumSamples],
+		float a, float b, float c, float d,
+		float value)
+	{
+		if (value <= samples[0])
+			return 0;
+		if (value >= samples[k_NumSamples - 1])
+			return 1;
+
+		int32 i = 1;
+		while (i < k_NumSamples - 1 && samples[i] < value)
+			++i;
+
+		// Linear initial guess within the bracketing segment
+		constexpr float segment = 1.f / (k_NumSamples - 1);
+		float lower = (i - 1) * segment;
+		float upper = i * segment;
+		float range = samples[i] - samples[i - 1];
+		float t = range > UE_SMALL_NUMBER
+			? lower + segment * (value - samples[i - 1]) / range
+			: lower;
+
+		for (int32 iteration = 0; iteration < k_MaxIterations; ++iteration) {
+			float error = ((a * t + b) * t + c) * t + d - value;
+			if (FMath::Abs(error) < k_Tolerance)
+				break;
+
+			if (error < 0)
+				lower = t;
+			else
+				upper = t;
+
+			float slope = (3.f * a * t + 2.f * b) * t + c;
+			float next = FMath::Abs(slope) > UE_SMALL_NUMBER ? t - error / slope : lower;
+
+			// Bisect when Newton would leave the bracket
+			t = next > lower && next < upper ? next : (lower + upper) * 0.5f;
+		}
+
+		return FMath::Clamp(t, 0.f, 1.f);
+	}
+};
+
+
+/**
+ * Four cubic bezier curves stored as a structure of arrays, so that `Get`,
+ * `YForX` and `XForY` can be evaluated for all of them at once with SIMD. Each
+ * lane is evaluated with its own curve and input value. Uses the same
+ * polynomial coefficients as FCubicBezierSolver.
+ *
+ * Without the solver's sample table, inversion starts from a linear guess
+ * across the whole curve, so it may take a few more (bracketed) Newton steps
+ * than the scalar path. It stops early once every lane has converged.
+ */
+struct FCubicBezierBatch
+{
+public:
+	inline static constexpr int32 k_Width = 4;
+	inline static constexpr int32 k_MaxIterations = 12;
+
+	/** Unused lanes hold a linear curve. */
+	FCubicBezierBatch()
+	{
+		for (int32 lane = 0; lane < k_Width; ++lane)
+			SetCurve(lane, FCubicBezier{});
+	}
+
+	void SetCurve(int32 lane, FCubicBezier const& curve)
+	{
+		FCubicBezierSolver::Point a, b, c, d;
+		FCubicBezierSolver::ComputeCoefficients(curve, a, b, c, d);
+		SetCoefficients(lane, a, b, c, d);
+	}
+
+	void SetCurve(int32 lane, FCubicBezierSolver const& solver)
+	{
+		SetCoefficients(lane, solver.A, solver.B, solver.C, solver.D);
+	}
+
+	/** Evaluate each lane's curve for the corresponding `t` value. */
+	FORCEINLINE void Get(VectorRegister4Float t, VectorRegister4Float& out_x, VectorRegister4Float& out_y) const
+	{
+		out_x = Evaluate(m_X, t);
+		out_y = Evaluate(m_Y, t);
+	}
+
+	/** Find the points along each curve where x == the corresponding value, and return their y values. */
+	FORCEINLINE VectorRegister4Float YForX(VectorRegister4Float x) const
+	{
+		return Evaluate(m_Y, SolveT(m_X, x));
+	}
+
+	/** Find the points along each curve where y == the corresponding value, and return their x values. */
+	FORCEINLINE VectorRegister4Float XForY(VectorRegister4Float y) const
+	{
+		return Evaluate(m_X, SolveT(m_Y, y));
+	}
+
+	// Unaligned array overloads for callers that don't deal in vector registers
+
+	FORCEINLINE void Get(float const* t, float* out_x, float* out_y) const
+	{
+		VectorRegister4Float x, y;
+		Get(VectorLoad(t), x, y);
+		VectorStore(x, out_x);
+		VectorStore(y, out_y);
+	}
+
+	FORCEINLINE void YForX(float const* x, float* out_y) const
+	{
+		VectorStore(YForX(VectorLoad(x)), out_y);
+	}
+
+	FORCEINLINE void XForY(float const* y, float* out_x) const
+	{
+		VectorStore(XForY(VectorLoad(y)), out_x);
+	}
+
+private:
+	/** One axis of each lane's polynomial, plus the data needed to invert it. */
+	struct FAxis
+	{
+		alignas(16) float A[k_Width];
+		alignas(16) float B[k_Width];
+		alignas(16) float C[k_Width];
+		alignas(16) float D[k_Width];
+		alignas(16) float Start[k_Width];
+		alignas(16) float End[k_Width];
+		alignas(16) float InvRange[k_Width];
+	};
+
+	FAxis m_X;
+	FAxis m_Y;
+
+	void SetCoefficients(
+		int32 lane,
+		FCubicBezierSolver::Point const& a,
+		FCubicBezierSolver::Point const& b,
+		FCubicBezierSolver::Point const& c,
+		FCubicBezierSolver::Point const& d)
+	{
+		check(lane >= 0 && lane < k_Width);
+
+		auto setAxis = [lane](FAxis& axis, float a, float b, float c, float d)
+		{
+			float range = a + b + c;
+			axis.A[lane] = a;
+			axis.B[lane] = b;
+			axis.C[lane] = c;
+			axis.D[lane] = d;
+			axis.Start[lane] = d;
+			axis.End[lane] = range + d;
+			axis.InvRange[lane] = FMath::Abs(range) > UE_SMALL_NUMBER ? 1.f / range : 0.f;
+		};
+
+		setAxis(m_X, a.X, b.X, c.X, d.X);
+		setAxis(m_Y, a.Y, b.Y, c.Y, d.Y);
+	}
+
+	FORCEINLINE static VectorRegister4Float Evaluate(FAxis const& axis, VectorRegister4Float t)
+	{
+		VectorRegister4Float result = VectorMultiplyAdd(VectorLoadAligned(axis.A), t, VectorLoadAligned(axis.B));
+		result = VectorMultiplyAdd(result, t, VectorLoadAligned(axis.C));
+		return VectorMultiplyAdd(result, t, VectorLoadAligned(axis.D));
+	}
+
+	static VectorRegister4Float SolveT(FAxis const& axis, VectorRegister4Float value)
+	{
+		VectorRegister4Float const zero = VectorZeroFloat();
+		VectorRegister4Float const one = VectorOneFloat();
+		VectorRegister4Float const half = VectorSetFloat1(0.5f);
+		VectorRegister4Float const tolerance = VectorSetFloat1(FCubicBezierSolver::k_Tolerance);
+
+		VectorRegister4Float const a = VectorLoadAligned(axis.A);
+		VectorRegister4Float const b = VectorLoadAligned(axis.B);
+		VectorRegister4Float const c = VectorLoadAligned(axis.C);
+		VectorRegister4Float const a3 = VectorMultiply(a, VectorSetFloat1(3.f));
+		VectorRegister4Float const b2 = VectorMultiply(b, VectorSetFloat1(2.f));
+
+		// Like the scalar solver, treat values past either end as the end. Left
+		// alone, a lane that can't converge keeps every lane iterating.
+		value = VectorMin(
+			VectorMax(value, VectorLoadAligned(axis.Start)),
+			VectorLoadAligned(axis.End));
+
+		// Linear initial guess across the whole curve
+		VectorRegister4Float t = VectorMultiply(
+			VectorSubtract(value, VectorLoadAligned(axis.Start)),
+			VectorLoadAligned(axis.InvRange));
+		t = VectorMin(VectorMax(t, zero), one);
+
+		VectorRegister4Float lower = zero;
+		VectorRegister4Float upper = one;
+
+		for (int32 iteration = 0; iteration < FCubicBezierBatch::k_MaxIterations; ++iteration) {
+			VectorRegister4Float error = VectorSubtract(Evaluate(axis, t), value);
+			VectorRegister4Float active = VectorCompareGT(VectorAbs(error), tolerance);
+			if (!VectorMaskBits(active))
+				break;
+
+			VectorRegister4Float below = VectorCompareLT(error, zero);
+			lower = VectorSelect(below, t, lower);
+			upper = VectorSelect(below, upper, t);
+
+			// A zero slope yields a non-finite step, which fails the bracket test
+			VectorRegister4Float slope = VectorMultiplyAdd(VectorMultiplyAdd(a3, t, b2), t, c);
+			VectorRegister4Float next = VectorSubtract(t, VectorDivide(error, slope));
+			VectorRegister4Float inBracket = VectorBitwiseAnd(
+				VectorCompareGT(next, lower),
+				VectorCompareLT(next, upper));
+
+			next = VectorSelect(inBracket, next, VectorMultiply(VectorAdd(lower, upper), half));
+			t = VectorSelect(active, next, t);
+		}
+
+		return VectorMin(VectorMax(t, zero), one);
+	}
+};
@@ -101,11 +101,23 @@ private:
 	void SetupCurves();
 
 	FInputActionValue ModifyRaw(float value, float deltaTime);
-	FInputActionValue ModifyRaw(FVector2D value, float deltaTime) const;
-	FInputActionValue ModifyRaw(FVector value, float deltaTime) const;
+	FInputActionValue ModifyRaw(FVector2D value, float deltaTime);
+	FInputActionValue ModifyRaw(FVector value, float deltaTime);
+	FVector ModifyAxes(FVector const& value, int32 numAxes, float deltaTime);
 
 	enum EPhase { None, Rising, Falling };
 
+	/** Start easing an axis between two output magnitudes along the rising or falling curve */
+	void StartEasing(int32 axis, EPhase phase, float from, float to);
+	/** Start easing an axis back to rest from its current output */
+	void StartFalling(int32 axis);
+	/**
+	 * Point an axis that's already moving toward the given magnitude at it
+	 * instead, keeping its output and rate continuous. Returns false if it
+	 * isn't moving that way.
+	 */
+	bool RetargetAxis(int32 axis, float magnitude);
+
 	/** The function applied to the axis while pushing away from the resting position. */
 	UPROPERTY(VisibleAnywhere, DisplayName="Rising Curve")
 	FCubicBezier m_CurveIn;
@@ -114,8 +126,11 @@ private:
 	UPROPERTY(VisibleAnywhere, DisplayName="Falling Curve")
 	FCubicBezier m_CurveOut;
 
-	FCubicBezier const* m_ActiveCurve = nullptr;
-	FCubicBezier const* m_PrevCurve = nullptr;
+	FCubicBezierSolver m_SolverIn;
+	FCubicBezierSolver m_SolverOut;
+
+	FCubicBezierSolver const* m_ActiveCurve = nullptr;
+	FCubicBezierSolver const* m_PrevCurve = nullptr;
 
 	FInputActionValue m_PrevInput = 0;
 	float m_PrevX = 0;
@@ -123,5 +138,31 @@ private:
 
 	EPhase m_Phase = None;
 
+	// Multi-axis state ---------------------------------------------------------
+	// Each component of a 2D/3D value follows the same curve model as a 1D
+	// value, with the active curve of every axis packed into one batch so they
+	// can all be advanced in a single pass.
+
+	static constexpr int32 k_MaxAxes = FCubicBezierBatch::k_Width;
+
+	FCubicBezierBatch m_AxisCurves;
+
+	alignas(16) float m_AxisX[k_MaxAxes] = {};
+	alignas(16) float m_AxisY[k_MaxAxes] = {};
+	alignas(16) float m_AxisDurations[k_MaxAxes] = {};
+	/** How far along its curve each axis moves per second */
+	alignas(16) float m_AxisSpeeds[k_MaxAxes] = {};
+
+	/** Each axis outputs `origin + scale * y` along its curve */
+	float m_AxisOrigins[k_MaxAxes] = {};
+	float m_AxisScales[k_MaxAxes] = {};
+
+	/** The last raw input of each axis */
+	float m_AxisTargets[k_MaxAxes] = {};
+	/** The last output magnitude of each axis */
+	float m_AxisMagnitudes[k_MaxAxes] = {};
+	float m_AxisSigns[k_MaxAxes] = { 1, 1, 1, 1 };
+	EPhase m_AxisPhases[k_MaxAxes] = { None, None, None, None };
+
 	bool m_NeedsInit = true;
 };
@@ -48,5 +48,22 @@ protected:
 		override;
 
 private:
-	static TMap<FName,FInputActionValue> s_AxisValues;
+	/** The value of every throttle axis for a single player */
+	struct FPlayerAxes
+	{
+		TWeakObjectPtr<UEnhancedPlayerInput const> Input;
+		TArray<FName> AxisIDs;
+		TArray<FInputActionValue> Values;
+	};
+
+	static TSparseArray<FPlayerAxes> s_Players;
+
+	// Handles into s_Players, resolved on the first tick for a given player and axis
+	int32 m_PlayerHandle = INDEX_NONE;
+	int32 m_AxisHandle = INDEX_NONE;
+	FName m_ResolvedAxisID = EName::None;
+
+	FInputActionValue& GetAxisValue(UEnhancedPlayerInput const* input);
+	bool IsAxisHandleValid(FPlayerAxes const& player, UEnhancedPlayerInput const* input) const;
+	void ResolveHandles(UEnhancedPlayerInput const* input);
 };
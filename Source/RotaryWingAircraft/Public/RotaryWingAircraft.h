@@ -8,6 +8,10 @@ class FRotaryWingAircraftModule : public IModuleInterface
 {
 public:
 	/** IModuleInterface implementation */
-	void StartupModule() override {}
-	void ShutdownModule() override {}
+	void StartupModule() override;
+	void ShutdownModule() override;
+
+private:
+	FDelegateHandle m_PostActorTickHandle;
+	FDelegateHandle m_WorldCleanupHandle;
 };
@@ -20,6 +20,7 @@ public class RotaryWingAircraft : ModuleRules {
 			"RenderCore",
 			"RHI",
 			"RHICore",
+			"SignificanceManager",
 		});
 	}
 }
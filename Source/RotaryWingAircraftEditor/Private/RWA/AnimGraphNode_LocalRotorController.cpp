@@ -0,0 +1,62 @@
+#include "RWA/AnimGraphNode_LocalRotorController.h"
+
+#include "RWA/HeliAnimInstance.h"
+#include "Kismet2/BlueprintEditorUtils.h"
+#include "Kismet2/CompilerResultsLog.h"
+
+#define LOCTEXT_NAMESPACE "A3Nodes"
+
+
+FText UAnimGraphNode_RWA_LocalRotorController::GetNodeTitle(ENodeTitleType::Type type) const
+{
+	if (type == ENodeTitleType::ListView || type == ENodeTitleType::MenuTitle)
+		return LOCTEXT(
+			"AnimGraphNode_RWA_LocalRotorController_MenuTitle",
+			"Local-Space Rotor Controller for Rotary-Wing Aircraft"
+		);
+
+	return LOCTEXT("AnimGraphNode_RWA_LocalRotorController", "Rotor Controller (Local Space)");
+}
+
+FText UAnimGraphNode_RWA_LocalRotorController::GetTooltipText() const
+{
+	return LOCTEXT(
+		"AnimGraphNode_RWA_LocalRotorController_Tooltip",
+		"Rotates the aircraft's rotor systems based on Heli Movement Component "
+			"setup, operating directly on the local-space pose. Cheaper than the "
+			"skeletal-control Rotor Controller, but assumes the rotor bones' "
+			"ancestors aren't animated. This only works when the owner is a Heli "
+			"actor."
+	);
+}
+
+FString UAnimGraphNode_RWA_LocalRotorController::GetNodeCategory() const
+{
+	return TEXT("Rotary-Wing Aircraft");
+}
+
+bool UAnimGraphNode_RWA_LocalRotorController::IsCompatibleWithGraph(UEdGraph const* graph) const
+{
+	UBlueprint* bp = FBlueprintEditorUtils::FindBlueprintForGraph(graph);
+	return (
+		bp != nullptr
+		&& bp->ParentClass->IsChildOf<URWA_HeliAnimInstance>()
+		&& Super::IsCompatibleWithGraph(graph)
+	);
+}
+
+void UAnimGraphNode_RWA_LocalRotorController::ValidateAnimNodePostCompile(
+	FCompilerResultsLog& msgLog,
+	UAnimBlueprintGeneratedClass* compiledClass,
+	int32 compiledNodeIdx)
+{
+	if (!compiledClass->IsChildOf<URWA_HeliAnimInstance>())
+		msgLog.Error(
+			TEXT("@@ is only allowed in HeliAnimInstance. Change animation "
+				"blueprint parent to HeliAnimInstance to fix."),
+			this
+		);
+}
+
+
+#undef LOCTEXT_NAMESPACE
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "AnimGraphNode_Base.h"
+#include "RWA/AnimNode_LocalRotorController.h"
+
+#include "AnimGraphNode_LocalRotorController.generated.h"
+
+
+UCLASS(MinimalAPI)
+class UAnimGraphNode_RWA_LocalRotorController
+	: public UAnimGraphNode_Base
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, Category="Settings", DisplayName="Node")
+	FAnimNode_RWA_LocalRotorController m_Node;
+
+public:
+	UAnimGraphNode_RWA_LocalRotorController() : Super() {}
+
+	FText GetNodeTitle(ENodeTitleType::Type type) const override;
+	FText GetTooltipText() const override;
+	FString GetNodeCategory() const override;
+	bool IsCompatibleWithGraph(UEdGraph const* graph) const override;
+
+	void ValidateAnimNodePostCompile(
+		FCompilerResultsLog& msgLog,
+		UAnimBlueprintGeneratedClass* compiledClass,
+		int32 compiledNodeIdx)
+		override;
+};